@@ -63,7 +63,7 @@ void ApproximateCoplanarFilter::addArgs(ProgramArgs& args)
 {
     args.add("knn", "k-Nearest Neighbors", m_knn, 8);
     args.add("thresh1", "Threshold 1", m_thresh1, 25.0);
-    args.add("thresh2", "Threshold 2", m_thresh1, 6.0);
+    args.add("thresh2", "Threshold 2", m_thresh2, 6.0);
 }
 
 
@@ -76,25 +76,17 @@ void ApproximateCoplanarFilter::filter(PointView& view)
 {
     using namespace Eigen;
 
-    KD3Index kdi(view);
-    kdi.build();
+    KD3Index& kdi = view.build3dIndex(threads());
 
+    // find the k-nearest neighbors of every point
+    NeighborTable neighbors = kdi.knnAll(m_knn, threads());
+
+    // compute the eigen decomposition of every neighborhood
+    std::vector<EigenFeatures> features =
+        computeEigenFeatures(view, neighbors, threads());
     for (PointId i = 0; i < view.size(); ++i)
     {
-        // find the k-nearest neighbors
-        double x = view.getFieldAs<double>(Dimension::Id::X, i);
-        double y = view.getFieldAs<double>(Dimension::Id::Y, i);
-        double z = view.getFieldAs<double>(Dimension::Id::Z, i);
-        auto ids = kdi.neighbors(x, y, z, m_knn);
-
-        // compute covariance of the neighborhood
-        auto B = computeCovariance(view, ids);
-
-        // perform the eigen decomposition
-        SelfAdjointEigenSolver<Matrix3f> solver(B);
-        if (solver.info() != Success)
-            throw pdal_error("Cannot perform eigen decomposition.");
-        auto ev = solver.eigenvalues();
+        const Vector3d& ev = features[i].values;
 
         // test eigenvalues to label points that are approximately coplanar
         if ((ev[1] > m_thresh1 * ev[0]) && (m_thresh2 * ev[1] > ev[2]))
@@ -42,6 +42,7 @@
 #include <ogr_spatialref.h>
 
 #include <array>
+#include <numeric>
 
 namespace pdal
 {
@@ -135,6 +136,9 @@ void ColorizationFilter::addArgs(ProgramArgs& args)
 {
     args.add("raster", "Raster filename", m_rasterFilename);
     args.add("dimensions", "Dimensions to use for colorization", m_dimSpec);
+    args.add("bilinear", "Interpolate raster values bilinearly", m_bilinear);
+    args.add("cache_size", "Size of the raster block cache in megabytes",
+        m_cacheSize, 256.0);
 }
 
 
@@ -183,37 +187,105 @@ void ColorizationFilter::ready(PointTableRef table)
             throw pdal_error(getName() + ": " + m_raster->errorMsg());
         }
     }
+    m_raster->setCacheSize((std::size_t)(m_cacheSize * 1024 * 1024));
+
+    for (const BandInfo& b : m_bands)
+        if (b.m_band < 1 || (int)b.m_band > m_raster->m_band_count)
+        {
+            std::ostringstream oss;
+            oss << getName() << ": band " << b.m_band << " requested for "
+                "dimension '" << b.m_name << "' doesn't exist in raster '" <<
+                m_rasterFilename << "'.";
+            throw pdal_error(oss.str());
+        }
 }
 
 
-bool ColorizationFilter::processOne(PointRef& point)
+void ColorizationFilter::colorize(PointRef& point, const double *values)
 {
-    static std::vector<double> data;
+    for (const BandInfo& b : m_bands)
+        point.setField(b.m_dim, values[b.m_band - 1] * b.m_scale);
+}
 
-    double x = point.getFieldAs<double>(Dimension::Id::X);
-    double y = point.getFieldAs<double>(Dimension::Id::Y);
 
-    if (m_raster->read(x, y, data) == gdal::GDALError::None)
+// Read raster values for the points in a batch and colorize the points
+// that fall within the raster.
+void ColorizationFilter::colorize(PointRef& point,
+    const std::vector<PointId>& points)
+{
+    const std::size_t count = points.size();
+    m_x.resize(count);
+    m_y.resize(count);
+    for (std::size_t i = 0; i < count; ++i)
     {
-        int i(0);
-        for (auto bi = m_bands.begin(); bi != m_bands.end(); ++bi)
+        point.setPointId(points[i]);
+        m_x[i] = point.getFieldAs<double>(Dimension::Id::X);
+        m_y[i] = point.getFieldAs<double>(Dimension::Id::Y);
+    }
+
+    if (m_raster->read(m_x.data(), m_y.data(), count, m_data, m_valid,
+        m_bilinear) != gdal::GDALError::None)
+        throw pdal_error(getName() + ": " + m_raster->errorMsg());
+
+    const std::size_t bandCount = m_raster->m_band_count;
+    for (std::size_t i = 0; i < count; ++i)
+        if (m_valid[i])
         {
-            BandInfo& b = *bi;
-            point.setField(b.m_dim, data[i] * b.m_scale);
-            ++i;
+            point.setPointId(points[i]);
+            colorize(point, m_data.data() + i * bandCount);
         }
-        return true;
-    }
-    return false;
 }
 
+
+bool ColorizationFilter::processOne(PointRef& point)
+{
+    double x = point.getFieldAs<double>(Dimension::Id::X);
+    double y = point.getFieldAs<double>(Dimension::Id::Y);
+
+    if (m_raster->read(&x, &y, 1, m_data, m_valid, m_bilinear) !=
+        gdal::GDALError::None)
+        throw pdal_error(getName() + ": " + m_raster->errorMsg());
+    if (!m_valid[0])
+        return false;
+    colorize(point, m_data.data());
+    return true;
+}
+
+
+point_count_t ColorizationFilter::processBatch(StreamPointTable& table,
+    point_count_t count, SkipMask& skips)
+{
+    std::vector<PointId> points;
+    points.reserve(count);
+    for (PointId idx = 0; idx < count; ++idx)
+        if (!skips[idx])
+            points.push_back(idx);
+
+    PointRef point(table, 0);
+    colorize(point, points);
+
+    // Points outside of the raster are filtered out, as in processOne().
+    for (std::size_t i = 0; i < points.size(); ++i)
+        if (!m_valid[i])
+            skips[points[i]] = 1;
+    return count;
+}
+
+
 void ColorizationFilter::filter(PointView& view)
 {
+    // Points are colorized in chunks to bound the memory used for
+    // coordinates and raster values.
+    const point_count_t chunkSize = 1 << 20;
+
     PointRef point = view.point(0);
-    for (PointId idx = 0; idx < view.size(); ++idx)
+    std::vector<PointId> points;
+    for (PointId begin = 0; begin < view.size(); begin += chunkSize)
     {
-        point.setPointId(idx);
-        processOne(point);
+        PointId end = (std::min)(begin + chunkSize, view.size());
+        points.resize(end - begin);
+        std::iota(points.begin(), points.end(), begin);
+        colorize(point, points);
     }
 }
 
@@ -72,7 +72,7 @@ public:
     };
 
 
-    ColorizationFilter()
+    ColorizationFilter() : m_bilinear(false), m_cacheSize(256.0)
     {}
     ColorizationFilter& operator=(const ColorizationFilter&) = delete;
     ColorizationFilter(const ColorizationFilter&) = delete;
@@ -86,12 +86,27 @@ private:
     virtual void initialize();
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void ready(PointTableRef table);
+    virtual bool streamable() const
+        { return true; }
     virtual bool processOne(PointRef& point);
+    virtual point_count_t processBatch(StreamPointTable& table,
+        point_count_t count, SkipMask& skips);
     virtual void filter(PointView& view);
 
+    void colorize(PointRef& point, const double *values);
+    void colorize(PointRef& point, const std::vector<PointId>& points);
+
     StringList m_dimSpec;
     std::string m_rasterFilename;
     std::vector<BandInfo> m_bands;
+    bool m_bilinear;
+    double m_cacheSize;
+
+    // Scratch space for batches of points.
+    std::vector<double> m_x;
+    std::vector<double> m_y;
+    std::vector<double> m_data;
+    std::vector<uint8_t> m_valid;
 
     std::unique_ptr<gdal::Raster> m_raster;
 };
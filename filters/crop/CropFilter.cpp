@@ -90,7 +90,7 @@ void CropFilter::initialize()
             if (!m_assignedSrs.empty())
                 poly.setSpatialReference(m_assignedSrs);
             g.m_geom = poly;
-            m_geoms.push_back(g);
+            m_geoms.push_back(std::move(g));
         }
     }
 }
@@ -103,6 +103,7 @@ void CropFilter::ready(PointTableRef table)
         // If we already overrode the SRS, use that instead
         if (m_assignedSrs.empty())
             geom.m_geom.setSpatialReference(table.anySpatialReference());
+        geom.m_index.reset(new PolygonIndex(geom.m_geom));
     }
 }
 
@@ -121,6 +122,45 @@ bool CropFilter::processOne(PointRef& point)
 }
 
 
+point_count_t CropFilter::processBatch(StreamPointTable& table,
+    point_count_t count, SkipMask& skips)
+{
+    if (m_bounds.empty() && m_geoms.empty())
+        return count;
+
+    // Pull the coordinates once from the table for all the tests.
+    PointRef point(table, 0);
+    std::vector<double> x(count);
+    std::vector<double> y(count);
+    for (PointId idx = 0; idx < count; ++idx)
+    {
+        if (skips[idx])
+            continue;
+        point.setPointId(idx);
+        x[idx] = point.getFieldAs<double>(Dimension::Id::X);
+        y[idx] = point.getFieldAs<double>(Dimension::Id::Y);
+    }
+
+    for (auto& box : m_bounds)
+    {
+        const BOX2D b(box.to2d());
+        for (PointId idx = 0; idx < count; ++idx)
+            if (m_cropOutside == b.contains(x[idx], y[idx]))
+                skips[idx] = 1;
+    }
+
+    std::vector<uint8_t> covered(count);
+    for (auto& geom : m_geoms)
+    {
+        geom.m_index->covers(x.data(), y.data(), count, covered.data());
+        for (PointId idx = 0; idx < count; ++idx)
+            if (m_cropOutside == (bool)covered[idx])
+                skips[idx] = 1;
+    }
+    return count;
+}
+
+
 PointViewSet CropFilter::run(PointViewPtr view)
 {
     PointViewSet viewSet;
@@ -133,31 +173,78 @@ PointViewSet CropFilter::run(PointViewPtr view)
         return viewSet;
     }
 
-    for (auto& geom : m_geoms)
+    // If this is the first time through or the SRS has changed,
+    // prepare the crop polygons.
+    if (srs != m_lastSrs)
     {
-        // If this is the first time through or the SRS has changed,
-        // prepare the crop polygon.
-        if (srs != m_lastSrs)
+        for (auto& geom : m_geoms)
         {
             geom.m_geom = geom.m_geom.transform(srs);
+            geom.m_index.reset(new PolygonIndex(geom.m_geom));
         }
-
-        PointViewPtr outView = view->makeNew();
-        crop(geom, *view, *outView);
-        viewSet.insert(outView);
+        m_regionIndex.reset();
     }
     m_lastSrs = srs;
 
-    for (auto& box : m_bounds)
+    // One output view for each polygon, then one for each box.
+    std::vector<PointViewPtr> outViews;
+    for (size_t i = 0; i < m_geoms.size() + m_bounds.size(); ++i)
+    {
+        outViews.push_back(view->makeNew());
+        viewSet.insert(outViews.back());
+    }
+
+    std::vector<double> x(view->size());
+    std::vector<double> y(view->size());
+    view->getFieldsAs(Dimension::Id::X, 0, view->size(), x.data());
+    view->getFieldsAs(Dimension::Id::Y, 0, view->size(), y.data());
+
+    if (m_cropOutside)
     {
-        PointViewPtr outView = view->makeNew();
-        crop(box.to2d(), *view, *outView);
-        viewSet.insert(outView);
+        // A point outside a region is kept by all but the few regions
+        // around it, so there's nothing to gain from looking them up.
+        for (size_t i = 0; i < m_geoms.size(); ++i)
+            crop(m_geoms[i], x, y, *view, *outViews[i]);
+        for (size_t i = 0; i < m_bounds.size(); ++i)
+            crop(m_bounds[i].to2d(), *view,
+                *outViews[m_geoms.size() + i]);
     }
+    else
+        cropInside(x, y, *view, outViews);
     return viewSet;
 }
 
 
+void CropFilter::cropInside(const std::vector<double>& x,
+    const std::vector<double>& y, PointView& input,
+    std::vector<PointViewPtr>& outViews)
+{
+    // Index the bounds of all the regions, so that each point is only
+    // tested against the regions whose bounds hold it.
+    if (!m_regionIndex)
+    {
+        std::vector<BOX2D> regions;
+        for (auto& geom : m_geoms)
+            regions.push_back(geom.m_index->bounds());
+        for (auto& box : m_bounds)
+            regions.push_back(box.to2d());
+        m_regionIndex.reset(new BoxIndex(regions));
+    }
+
+    std::vector<uint32_t> hits;
+    for (PointId idx = 0; idx < input.size(); ++idx)
+    {
+        m_regionIndex->query(x[idx], y[idx], hits);
+
+        // Points in a box's bounds are in the box.
+        for (uint32_t h : hits)
+            if (h >= m_geoms.size() ||
+                m_geoms[h].m_index->covers(x[idx], y[idx]))
+                outViews[h]->appendPoint(input, idx);
+    }
+}
+
+
 bool CropFilter::crop(PointRef& point, const BOX2D& box)
 {
     double x = point.getFieldAs<double>(Dimension::Id::X);
@@ -181,19 +268,22 @@ void CropFilter::crop(const BOX2D& box, PointView& input, PointView& output)
 
 bool CropFilter::crop(PointRef& point, const GeomPkg& g)
 {
-    bool covers = g.m_geom.covers(point);
+    double x = point.getFieldAs<double>(Dimension::Id::X);
+    double y = point.getFieldAs<double>(Dimension::Id::Y);
+
+    bool covers = g.m_index->covers(x, y);
     bool keep = (m_cropOutside != covers);
     return keep;
 }
 
-void CropFilter::crop(const GeomPkg& g, PointView& input, PointView& output)
+void CropFilter::crop(const GeomPkg& g, const std::vector<double>& x,
+    const std::vector<double>& y, PointView& input, PointView& output)
 {
-    PointRef point = input.point(0);
+    std::vector<uint8_t> covered(input.size());
+    g.m_index->covers(x.data(), y.data(), input.size(), covered.data());
     for (PointId idx = 0; idx < input.size(); ++idx)
     {
-        point.setPointId(idx);
-        bool covers = g.m_geom.covers(point);
-        bool keep = (m_cropOutside != covers);
+        bool keep = (m_cropOutside != (bool)covered[idx]);
         if (keep)
             output.appendPoint(input, idx);
     }
@@ -34,10 +34,15 @@
 
 #pragma once
 
+#include <pdal/BoxIndex.hpp>
 #include <pdal/Filter.hpp>
 #include <pdal/Polygon.hpp>
+#include <pdal/PolygonIndex.hpp>
 #include <pdal/plugin.hpp>
 
+#include <memory>
+#include <vector>
+
 extern "C" int32_t CropFilter_ExitFunc();
 extern "C" PF_ExitFunc CropFilter_InitPlugin();
 
@@ -72,19 +77,29 @@ private:
 
         Polygon m_geom;
         Polygon m_geomXform;
+        std::unique_ptr<PolygonIndex> m_index;
     };
 
     std::vector<GeomPkg> m_geoms;
+    std::unique_ptr<BoxIndex> m_regionIndex;
 
     void addArgs(ProgramArgs& args);
     virtual void initialize();
     virtual void ready(PointTableRef table);
+    virtual bool streamable() const
+        { return true; }
     virtual bool processOne(PointRef& point);
+    virtual point_count_t processBatch(StreamPointTable& table,
+        point_count_t count, SkipMask& skips);
     virtual PointViewSet run(PointViewPtr view);
     bool crop(PointRef& point, const BOX2D& box);
     void crop(const BOX2D& box, PointView& input, PointView& output);
     bool crop(PointRef& point, const GeomPkg& g);
-    void crop(const GeomPkg& g, PointView& input, PointView& output);
+    void crop(const GeomPkg& g, const std::vector<double>& x,
+        const std::vector<double>& y, PointView& input, PointView& output);
+    void cropInside(const std::vector<double>& x,
+        const std::vector<double>& y, PointView& input,
+        std::vector<PointViewPtr>& outViews);
 
     CropFilter& operator=(const CropFilter&); // not implemented
     CropFilter(const CropFilter&); // not implemented
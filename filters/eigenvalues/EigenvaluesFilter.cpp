@@ -62,6 +62,8 @@ std::string EigenvaluesFilter::getName() const
 void EigenvaluesFilter::addArgs(ProgramArgs& args)
 {
     args.add("knn", "k-Nearest neighbors", m_knn, 8);
+    args.add("features", "Add linearity, planarity and scattering "
+        "dimensions", m_features);
 }
 
 
@@ -70,35 +72,41 @@ void EigenvaluesFilter::addDimensions(PointLayoutPtr layout)
     m_e0 = layout->registerOrAssignDim("Eigenvalue0", Dimension::Type::Double);
     m_e1 = layout->registerOrAssignDim("Eigenvalue1", Dimension::Type::Double);
     m_e2 = layout->registerOrAssignDim("Eigenvalue2", Dimension::Type::Double);
+    if (m_features)
+    {
+        m_linearity =
+            layout->registerOrAssignDim("Linearity", Dimension::Type::Double);
+        m_planarity =
+            layout->registerOrAssignDim("Planarity", Dimension::Type::Double);
+        m_scattering =
+            layout->registerOrAssignDim("Scattering", Dimension::Type::Double);
+    }
 }
 
 void EigenvaluesFilter::filter(PointView& view)
 {
     using namespace Eigen;
 
-    KD3Index kdi(view);
-    kdi.build();
+    KD3Index& kdi = view.build3dIndex(threads());
+
+    // find the k-nearest neighbors of every point
+    NeighborTable neighbors = kdi.knnAll(m_knn, threads());
 
+    // compute the eigen decomposition of every neighborhood
+    std::vector<EigenFeatures> features =
+        computeEigenFeatures(view, neighbors, threads());
     for (PointId i = 0; i < view.size(); ++i)
     {
-        // find the k-nearest neighbors
-        double x = view.getFieldAs<double>(Dimension::Id::X, i);
-        double y = view.getFieldAs<double>(Dimension::Id::Y, i);
-        double z = view.getFieldAs<double>(Dimension::Id::Z, i);
-        auto ids = kdi.neighbors(x, y, z, m_knn);
-
-        // compute covariance of the neighborhood
-        auto B = computeCovariance(view, ids);
-
-        // perform the eigen decomposition
-        SelfAdjointEigenSolver<Matrix3f> solver(B);
-        if (solver.info() != Success)
-            throw pdal_error("Cannot perform eigen decomposition.");
-        auto ev = solver.eigenvalues();
-
-        view.setField(m_e0, i, ev[0]);
-        view.setField(m_e1, i, ev[1]);
-        view.setField(m_e2, i, ev[2]);
+        const EigenFeatures& f = features[i];
+        view.setField(m_e0, i, f.values[0]);
+        view.setField(m_e1, i, f.values[1]);
+        view.setField(m_e2, i, f.values[2]);
+        if (m_features)
+        {
+            view.setField(m_linearity, i, f.linearity());
+            view.setField(m_planarity, i, f.planarity());
+            view.setField(m_scattering, i, f.scattering());
+        }
     }
 }
 
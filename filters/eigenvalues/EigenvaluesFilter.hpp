@@ -65,10 +65,14 @@ public:
 
 private:
     int m_knn;
+    bool m_features;
     Dimension::Id m_e0, m_e1, m_e2;
+    Dimension::Id m_linearity, m_planarity, m_scattering;
 
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void addArgs(ProgramArgs& args);
+    virtual bool parallelSafe() const
+        { return true; }
     virtual void filter(PointView& view);
 };
 
@@ -70,6 +70,8 @@ private:
 
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void addArgs(ProgramArgs& args);
+    virtual bool parallelSafe() const
+        { return true; }
     virtual void filter(PointView& view);
 };
 
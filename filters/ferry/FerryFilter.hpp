@@ -62,7 +62,11 @@ private:
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void prepared(PointTableRef table);
     virtual void ready(PointTableRef table);
+    virtual bool streamable() const
+        { return true; }
     virtual bool processOne(PointRef& point);
+    virtual bool parallelSafe() const
+        { return true; }
     virtual void filter(PointView& view);
 
     FerryFilter& operator=(const FerryFilter&) = delete;
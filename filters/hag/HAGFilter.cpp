@@ -93,19 +93,22 @@ void HAGFilter::filter(PointView& view)
         throw pdal_error("HAGFilter: the input PointView does not appear to have any points classified as ground");
 
     // Build the 2D KD-tree.
-    KD2Index kdi(*gView);
-    kdi.build();
+    KD2Index& kdi = gView->build2dIndex(threads());
 
     // Second pass: Find Z difference between non-ground points and the nearest 
     // neighbor (2D) in the ground view.
-    for (PointId i = 0; i < ngView->size(); ++i)
+    point_count_t ngCount = ngView->size();
+    std::vector<double> x0(ngCount), y0(ngCount), z0(ngCount);
+    ngView->getFieldsAs(Dimension::Id::X, 0, ngCount, x0.data());
+    ngView->getFieldsAs(Dimension::Id::Y, 0, ngCount, y0.data());
+    ngView->getFieldsAs(Dimension::Id::Z, 0, ngCount, z0.data());
+    std::vector<double> z1(gView->size());
+    gView->getFieldsAs(Dimension::Id::Z, 0, gView->size(), z1.data());
+    for (PointId i = 0; i < ngCount; ++i)
     {
-        double x0 = ngView->getFieldAs<double>(Dimension::Id::X, i);
-        double y0 = ngView->getFieldAs<double>(Dimension::Id::Y, i);
-        double z0 = ngView->getFieldAs<double>(Dimension::Id::Z, i);
-        auto ids = kdi.neighbors(x0, y0, 1);
-        double z1 = gView->getFieldAs<double>(Dimension::Id::Z, ids[0]);
-        view.setField(Dimension::Id::HeightAboveGround, ngIdx[i], z0 - z1);
+        auto ids = kdi.neighbors(x0[i], y0[i], 1);
+        view.setField(Dimension::Id::HeightAboveGround, ngIdx[i],
+            z0[i] - z1[ids[0]]);
     }
 
     // Final pass: Ensure that all ground points have height value pegged at 0.
@@ -65,6 +65,8 @@ private:
 
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void prepared(PointTableRef table);
+    virtual bool parallelSafe() const
+        { return true; }
     virtual void filter(PointView& view);
 
     HAGFilter& operator=(const HAGFilter&); // not implemented
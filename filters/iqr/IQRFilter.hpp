@@ -66,6 +66,8 @@ private:
 
     virtual void addArgs(ProgramArgs& args);
     virtual void prepared(PointTableRef table);
+    virtual bool parallelSafe() const
+        { return true; }
     virtual PointViewSet run(PointViewPtr view);
 
     IQRFilter& operator=(const IQRFilter&); // not implemented
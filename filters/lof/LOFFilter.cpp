@@ -72,27 +72,26 @@ void LOFFilter::filter(PointView& view)
     using namespace Dimension;
     
     // Build the 3D KD-tree.
-    KD3Index index(view);
     log()->get(LogLevel::Debug) << "Building 3D KD-tree...\n";
-    index.build();
+    KD3Index& index = view.build3dIndex(threads());
     
-    // Increment the minimum number of points, as knnSearch will be returning
-    // the neighbors along with the query point.
-    m_minpts++;
-  
+    // Ask for one more neighbor than the minimum number of points, as
+    // knnSearch will be returning the neighbors along with the query point.
+    const point_count_t k = m_minpts + 1;
+
     // First pass: Compute the k-distance for each point.
     // The k-distance is the Euclidean distance to k-th nearest neighbor.
+    // The neighborhoods are found once and reused by all three passes.
     log()->get(LogLevel::Debug) << "Computing k-distances...\n";
-    for (PointId i = 0; i < view.size(); ++i)
+    point_count_t np = view.size();
+    NeighborTable neighbors = index.knnAll(k, threads());
+    std::vector<double> kdist(np);
+    for (PointId i = 0; i < np; ++i)
     {
-        double x = view.getFieldAs<double>(Id::X, i);
-        double y = view.getFieldAs<double>(Id::Y, i);
-        double z = view.getFieldAs<double>(Id::Z, i);
-        std::vector<PointId> indices(m_minpts);
-        std::vector<double> sqr_dists(m_minpts);
-        index.knnSearch(x, y, z, m_minpts, &indices, &sqr_dists);
-        view.setField(m_kdist, i, std::sqrt(sqr_dists[m_minpts-1]));
+        ColumnSpan<const double> sqr_dists = neighbors.sqrDistances(i);
+        kdist[i] = std::sqrt(sqr_dists[sqr_dists.size() - 1]);
     }
+    view.setFields(m_kdist, 0, np, kdist.data());
     
     // Second pass: Compute the local reachability distance for each point.
     // For each neighbor point, the reachability distance is the maximum value
@@ -100,45 +99,39 @@ void LOFFilter::filter(PointView& view)
     // the current point. The lrd is the inverse of the mean of the reachability
     // distances.
     log()->get(LogLevel::Debug) << "Computing lrd...\n";
-    for (PointId i = 0; i < view.size(); ++i)
+    std::vector<double> lrd(np);
+    for (PointId i = 0; i < np; ++i)
     {
-        double x = view.getFieldAs<double>(Id::X, i);
-        double y = view.getFieldAs<double>(Id::Y, i);
-        double z = view.getFieldAs<double>(Id::Z, i);
-        std::vector<PointId> indices(m_minpts);
-        std::vector<double> sqr_dists(m_minpts);
-        index.knnSearch(x, y, z, m_minpts, &indices, &sqr_dists);
+        ColumnSpan<const PointId> indices = neighbors.neighbors(i);
+        ColumnSpan<const double> sqr_dists = neighbors.sqrDistances(i);
         double M1 = 0.0;
         point_count_t n = 0;
         for (PointId j = 0; j < indices.size(); ++j)
         {
-            double k = view.getFieldAs<double>(m_kdist, indices[j]);
-            double reachdist = std::max(k, std::sqrt(sqr_dists[j]));
+            double kd = kdist[indices[j]];
+            double reachdist = std::max(kd, std::sqrt(sqr_dists[j]));
             M1 += (reachdist - M1) / ++n;
         }
-        view.setField(m_lrd, i, 1.0 / M1);
+        lrd[i] = 1.0 / M1;
     }
+    view.setFields(m_lrd, 0, np, lrd.data());
     
     // Third pass: Compute the local outlier factor for each point.
     // The LOF is the average of the lrd's for a neighborhood of points.
     log()->get(LogLevel::Debug) << "Computing LOF...\n";
-    for (PointId i = 0; i < view.size(); ++i)
+    std::vector<double> lof(np);
+    for (PointId i = 0; i < np; ++i)
     {
-        double x = view.getFieldAs<double>(Id::X, i);
-        double y = view.getFieldAs<double>(Id::Y, i);
-        double z = view.getFieldAs<double>(Id::Z, i);
-        double lrdp = view.getFieldAs<double>(m_lrd, i);
-        std::vector<PointId> indices(m_minpts);
-        std::vector<double> sqr_dists(m_minpts);
-        index.knnSearch(x, y, z, m_minpts, &indices, &sqr_dists);
+        double lrdp = lrd[i];
         double M1 = 0.0;
         point_count_t n = 0;
-        for (auto const& j : indices)
+        for (auto const& j : neighbors.neighbors(i))
         {
-            M1 += (view.getFieldAs<double>(m_lrd, j) / lrdp - M1) / ++n;
+            M1 += (lrd[j] / lrdp - M1) / ++n;
         }
-        view.setField(m_lof, i, M1);
+        lof[i] = M1;
     }
+    view.setFields(m_lof, 0, np, lof.data());
 }
 
 } // namespace pdal
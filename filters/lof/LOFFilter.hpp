@@ -65,6 +65,8 @@ private:
     
     virtual void addArgs(ProgramArgs& args);
     virtual void addDimensions(PointLayoutPtr layout);
+    virtual bool parallelSafe() const
+        { return true; }
     virtual void filter(PointView& view);
 
     LOFFilter& operator=(const LOFFilter&); // not implemented
@@ -66,6 +66,8 @@ private:
 
     virtual void addArgs(ProgramArgs& args);
     virtual void prepared(PointTableRef table);
+    virtual bool parallelSafe() const
+        { return true; }
     virtual PointViewSet run(PointViewPtr view);
 
     MADFilter& operator=(const MADFilter&); // not implemented
@@ -34,6 +34,7 @@
 
 #include "MongusFilter.hpp"
 
+#include <pdal/Eigen.hpp>
 #include <pdal/pdal_macros.hpp>
 #include <pdal/PipelineManager.hpp>
 #include <buffer/BufferReader.hpp>
@@ -345,21 +346,19 @@ std::vector<PointId> MongusFilter::processGround(PointViewPtr view)
     cz.setConstant(std::numeric_limits<double>::max());
 
     // find initial set of Z minimums at native resolution
+    std::vector<int> cells = computeCells(*view, m_numRows, m_numCols,
+                                          m_cellSize, m_bounds, threads());
     for (point_count_t i = 0; i < np; ++i)
     {
         using namespace Dimension;
-        double x = view->getFieldAs<double>(Id::X, i);
-        double y = view->getFieldAs<double>(Id::Y, i);
         double z = view->getFieldAs<double>(Id::Z, i);
 
-        int c = clamp(getColIndex(x, m_cellSize), 0, m_numCols-1);
-        int r = clamp(getRowIndex(y, m_cellSize), 0, m_numRows-1);
-
-        if (z < cz(r, c))
+        int cell = cells[i];
+        if (z < cz(cell))
         {
-            cx(r, c) = x;
-            cy(r, c) = y;
-            cz(r, c) = z;
+            cx(cell) = view->getFieldAs<double>(Id::X, i);
+            cy(cell) = view->getFieldAs<double>(Id::Y, i);
+            cz(cell) = z;
         }
     }
 
@@ -718,56 +717,9 @@ Eigen::MatrixXd MongusFilter::matrixOpen(Eigen::MatrixXd data, int radius)
 
     MatrixXd data2 = padMatrix(data, radius);
 
-    int nrows = data2.rows();
-    int ncols = data2.cols();
-
     // first min, then max of min
-    MatrixXd minZ = MatrixXd::Constant(nrows, ncols,
-                                       std::numeric_limits<double>::max());
-    MatrixXd maxZ = MatrixXd::Constant(nrows, ncols,
-                                       std::numeric_limits<double>::lowest());
-    for (auto c = 0; c < ncols; ++c)
-    {
-        for (auto r = 0; r < nrows; ++r)
-        {
-            int cs = clamp(c-radius, 0, ncols-1);
-            int ce = clamp(c+radius, 0, ncols-1);
-            int rs = clamp(r-radius, 0, nrows-1);
-            int re = clamp(r+radius, 0, nrows-1);
-
-            for (auto col = cs; col <= ce; ++col)
-            {
-                for (auto row = rs; row <= re; ++row)
-                {
-                    if ((row-r)*(row-r)+(col-c)*(col-c) > radius*radius)
-                        continue;
-                    if (data2(row, col) < minZ(r, c))
-                        minZ(r, c) = data2(row, col);
-                }
-            }
-        }
-    }
-    for (auto c = 0; c < ncols; ++c)
-    {
-        for (auto r = 0; r < nrows; ++r)
-        {
-            int cs = clamp(c-radius, 0, ncols-1);
-            int ce = clamp(c+radius, 0, ncols-1);
-            int rs = clamp(r-radius, 0, nrows-1);
-            int re = clamp(r+radius, 0, nrows-1);
-
-            for (auto col = cs; col <= ce; ++col)
-            {
-                for (auto row = rs; row <= re; ++row)
-                {
-                    if ((row-r)*(row-r)+(col-c)*(col-c) > radius*radius)
-                        continue;
-                    if (minZ(row, col) > maxZ(r, c))
-                        maxZ(r, c) = minZ(row, col);
-                }
-            }
-        }
-    }
+    MatrixXd minZ = erodeDisk(data2, radius, threads());
+    MatrixXd maxZ = dilateDisk(minZ, radius, threads());
 
     return maxZ.block(radius, radius, data.rows(), data.cols());
 }
@@ -778,56 +730,9 @@ Eigen::MatrixXd MongusFilter::matrixClose(Eigen::MatrixXd data, int radius)
 
     MatrixXd data2 = padMatrix(data, radius);
 
-    int nrows = data2.rows();
-    int ncols = data2.cols();
-
-    // first min, then max of min
-    MatrixXd minZ = MatrixXd::Constant(nrows, ncols,
-                                       std::numeric_limits<double>::max());
-    MatrixXd maxZ = MatrixXd::Constant(nrows, ncols,
-                                       std::numeric_limits<double>::lowest());
-    for (auto c = 0; c < ncols; ++c)
-    {
-        for (auto r = 0; r < nrows; ++r)
-        {
-            int cs = clamp(c-radius, 0, ncols-1);
-            int ce = clamp(c+radius, 0, ncols-1);
-            int rs = clamp(r-radius, 0, nrows-1);
-            int re = clamp(r+radius, 0, nrows-1);
-
-            for (auto col = cs; col <= ce; ++col)
-            {
-                for (auto row = rs; row <= re; ++row)
-                {
-                    if ((row-r)*(row-r)+(col-c)*(col-c) > radius*radius)
-                        continue;
-                    if (data2(row, col) > maxZ(r, c))
-                        maxZ(r, c) = data2(row, col);
-                }
-            }
-        }
-    }
-    for (auto c = 0; c < ncols; ++c)
-    {
-        for (auto r = 0; r < nrows; ++r)
-        {
-            int cs = clamp(c-radius, 0, ncols-1);
-            int ce = clamp(c+radius, 0, ncols-1);
-            int rs = clamp(r-radius, 0, nrows-1);
-            int re = clamp(r+radius, 0, nrows-1);
-
-            for (auto col = cs; col <= ce; ++col)
-            {
-                for (auto row = rs; row <= re; ++row)
-                {
-                    if ((row-r)*(row-r)+(col-c)*(col-c) > radius*radius)
-                        continue;
-                    if (maxZ(row, col) < minZ(r, c))
-                        minZ(r, c) = maxZ(row, col);
-                }
-            }
-        }
-    }
+    // first max, then min of max
+    MatrixXd maxZ = dilateDisk(data2, radius, threads());
+    MatrixXd minZ = erodeDisk(maxZ, radius, threads());
 
     return minZ.block(radius, radius, data.rows(), data.cols());
 }
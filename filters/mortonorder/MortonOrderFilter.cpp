@@ -39,6 +39,7 @@
 #include <iostream>
 #include <limits>
 #include <map>
+#include <vector>
 
 namespace pdal
 {
@@ -99,12 +100,14 @@ PointViewSet MortonOrderFilter::run(PointViewPtr inView)
     double xrange = buffer_bounds.maxx - buffer_bounds.minx;
     double yrange = buffer_bounds.maxy - buffer_bounds.miny;
 
-    for (PointId idx = 0; idx < inView->size(); idx++)
+    point_count_t np = inView->size();
+    std::vector<double> xs(np), ys(np);
+    inView->getFieldsAs(Dimension::Id::X, 0, np, xs.data());
+    inView->getFieldsAs(Dimension::Id::Y, 0, np, ys.data());
+    for (PointId idx = 0; idx < np; idx++)
     {
-        double xpos = (inView->getFieldAs<double>(Dimension::Id::X, idx) -
-            buffer_bounds.minx) / xrange;
-        double ypos = (inView->getFieldAs<double>(Dimension::Id::Y, idx) -
-            buffer_bounds.miny) / yrange;
+        double xpos = (xs[idx] - buffer_bounds.minx) / xrange;
+        double ypos = (ys[idx] - buffer_bounds.miny) / yrange;
         Coord loc(xpos, ypos);
         sorted.insert(std::make_pair(loc, idx));
     }
@@ -56,6 +56,8 @@ public:
     std::string getName() const;
 
 private:
+    virtual bool parallelSafe() const
+        { return true; }
     virtual PointViewSet run(PointViewPtr view);
 };
 
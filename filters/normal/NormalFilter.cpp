@@ -77,36 +77,21 @@ void NormalFilter::filter(PointView& view)
 {
     using namespace Eigen;
 
-    KD3Index kdi(view);
-    kdi.build();
+    KD3Index& kdi = view.build3dIndex(threads());
 
+    // find the k-nearest neighbors of every point
+    NeighborTable neighbors = kdi.knnAll(m_knn, threads());
+
+    // compute the eigen decomposition of every neighborhood
+    std::vector<EigenFeatures> features =
+        computeEigenFeatures(view, neighbors, threads());
     for (PointId i = 0; i < view.size(); ++i)
     {
-        // find the k-nearest neighbors
-        double x = view.getFieldAs<double>(Dimension::Id::X, i);
-        double y = view.getFieldAs<double>(Dimension::Id::Y, i);
-        double z = view.getFieldAs<double>(Dimension::Id::Z, i);
-        auto ids = kdi.neighbors(x, y, z, m_knn);
-
-        // compute covariance of the neighborhood
-        auto B = computeCovariance(view, ids);
-
-        // perform the eigen decomposition
-        SelfAdjointEigenSolver<Matrix3f> solver(B);
-        if (solver.info() != Success)
-            throw pdal_error("Cannot perform eigen decomposition.");
-        auto eval = solver.eigenvalues();
-        auto evec = solver.eigenvectors().col(0);
-
-        view.setField(m_nx, i, evec[0]);
-        view.setField(m_ny, i, evec[1]);
-        view.setField(m_nz, i, evec[2]);
-
-        double sum = eval[0] + eval[1] + eval[2];
-        if (sum != 0)
-            view.setField(m_curvature, i, std::fabs(eval[0]/sum));
-        else
-            view.setField(m_curvature, i, 0);
+        const EigenFeatures& f = features[i];
+        view.setField(m_nx, i, f.normal[0]);
+        view.setField(m_ny, i, f.normal[1]);
+        view.setField(m_nz, i, f.normal[2]);
+        view.setField(m_curvature, i, f.curvature());
     }
 }
 
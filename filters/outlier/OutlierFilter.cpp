@@ -34,6 +34,7 @@
 
 #include "OutlierFilter.hpp"
 
+#include <pdal/GridIndex.hpp>
 #include <pdal/KDIndex.hpp>
 #include <pdal/util/Utils.hpp>
 #include <pdal/pdal_macros.hpp>
@@ -67,6 +68,13 @@ void OutlierFilter::addArgs(ProgramArgs& args)
     args.add("multiplier", "Standard deviation threshold", m_multiplier, 2.0);
     args.add("classify", "Apply classification labels?", m_classify, true);
     args.add("extract", "Extract ground returns?", m_extract);
+    addIndexArg(args, m_indexType);
+}
+
+
+void OutlierFilter::initialize()
+{
+    m_useGrid = (parseIndexType(getName(), m_indexType) == IndexType::Grid);
 }
 
 
@@ -78,21 +86,25 @@ void OutlierFilter::addDimensions(PointLayoutPtr layout)
 
 Indices OutlierFilter::processRadius(PointViewPtr inView)
 {
-    KD3Index index(*inView);
-    index.build();
-
     point_count_t np = inView->size();
 
     std::vector<PointId> inliers, outliers;
 
+    NeighborTable neighbors;
+    if (m_useGrid)
+    {
+        Grid3Index index(*inView, m_radius);
+        index.build(threads());
+        neighbors = index.radiusAll(m_radius, threads());
+    }
+    else
+    {
+        KD3Index& index = inView->build3dIndex(threads());
+        neighbors = index.radiusAll(m_radius, threads());
+    }
     for (PointId i = 0; i < np; ++i)
     {
-        double x = inView->getFieldAs<double>(Dimension::Id::X, i);
-        double y = inView->getFieldAs<double>(Dimension::Id::Y, i);
-        double z = inView->getFieldAs<double>(Dimension::Id::Z, i);
-
-        auto ids = index.radius(x, y, z, m_radius);
-        if (ids.size() > size_t(m_minK))
+        if (neighbors.neighbors(i).size() > size_t(m_minK))
             inliers.push_back(i);
         else
             outliers.push_back(i);
@@ -104,30 +116,30 @@ Indices OutlierFilter::processRadius(PointViewPtr inView)
 
 Indices OutlierFilter::processStatistical(PointViewPtr inView)
 {
-    KD3Index index(*inView);
-    index.build();
-
     point_count_t np = inView->size();
 
     std::vector<PointId> inliers, outliers;
 
+    // we increase the count by one because the query point itself will
+    // be included with a distance of 0
+    NeighborTable neighbors;
+    if (m_useGrid)
+    {
+        Grid3Index index(*inView);
+        index.build(threads());
+        neighbors = index.knnAll(m_meanK + 1, threads());
+    }
+    else
+    {
+        KD3Index& index = inView->build3dIndex(threads());
+        neighbors = index.knnAll(m_meanK + 1, threads());
+    }
+
     std::vector<double> distances(np);
     for (PointId i = 0; i < np; ++i)
     {
-        double x = inView->getFieldAs<double>(Dimension::Id::X, i);
-        double y = inView->getFieldAs<double>(Dimension::Id::Y, i);
-        double z = inView->getFieldAs<double>(Dimension::Id::Z, i);
-
-        // we increase the count by one because the query point itself will
-        // be included with a distance of 0
-        point_count_t count = m_meanK + 1;
-
-        std::vector<PointId> indices(count);
-        std::vector<double> sqr_dists(count);
-        index.knnSearch(x, y, z, count, &indices, &sqr_dists);
-
         double dist_sum = 0.0;
-        for (auto const& d : sqr_dists)
+        for (auto const& d : neighbors.sqrDistances(i))
             dist_sum += sqrt(d);
         distances[i] = dist_sum / m_meanK;
     }
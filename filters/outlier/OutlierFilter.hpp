@@ -73,11 +73,16 @@ private:
     double m_multiplier;
     bool m_classify;
     bool m_extract;
+    std::string m_indexType;
+    bool m_useGrid;
 
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void addArgs(ProgramArgs& args);
+    virtual void initialize();
     Indices processRadius(PointViewPtr inView);
     Indices processStatistical(PointViewPtr inView);
+    virtual bool parallelSafe() const
+        { return true; }
     virtual PointViewSet run(PointViewPtr view);
 
     OutlierFilter& operator=(const OutlierFilter&); // not implemented
@@ -34,9 +34,12 @@
 
 #include "PMFFilter.hpp"
 
+#include <pdal/Eigen.hpp>
+#include <pdal/GridIndex.hpp>
 #include <pdal/KDIndex.hpp>
 #include <pdal/pdal_macros.hpp>
 #include <pdal/util/ProgramArgs.hpp>
+#include <pdal/util/Utils.hpp>
 
 namespace pdal
 {
@@ -63,6 +66,13 @@ void PMFFilter::addArgs(ProgramArgs& args)
     args.add("classify", "Apply classification labels?", m_classify, true);
     args.add("extract", "Extract ground returns?", m_extract);
     args.add("approximate", "Use approximate algorithm?", m_approximate);
+    addIndexArg(args, m_indexType);
+}
+
+
+void PMFFilter::initialize()
+{
+    m_useGrid = (parseIndexType(getName(), m_indexType) == IndexType::Grid);
 }
 
 
@@ -75,24 +85,26 @@ std::vector<double> PMFFilter::morphOpen(PointViewPtr view, float radius)
 {
     point_count_t np(view->size());
 
-    KD2Index index(*view);
-    index.build();
+    NeighborTable neighbors;
+    if (m_useGrid)
+    {
+        Grid2Index index(*view, radius);
+        index.build(threads());
+        neighbors = index.radiusAll(radius, threads());
+    }
+    else
+    {
+        KD2Index& index = view->build2dIndex(threads());
+        neighbors = index.radiusAll(radius, threads());
+    }
 
     std::vector<double> minZ(np), maxZ(np);
-    typedef std::vector<PointId> PointIdVec;
-    std::map<PointId, PointIdVec> neighborMap;
 
     // erode
     for (PointId i = 0; i < np; ++i)
     {
-        double x = view->getFieldAs<double>(Dimension::Id::X, i);
-        double y = view->getFieldAs<double>(Dimension::Id::Y, i);
-        auto ids = index.radius(x, y, radius);
-
-        // neighborMap.insert(std::pair<PointId, std::vector<PointId>(i, ids));
-        neighborMap[i] = ids;
         double localMin(std::numeric_limits<double>::max());
-        for (auto const& j : ids)
+        for (auto const& j : neighbors.neighbors(i))
         {
             double z = view->getFieldAs<double>(Dimension::Id::Z, j);
             if (z < localMin)
@@ -104,9 +116,8 @@ std::vector<double> PMFFilter::morphOpen(PointViewPtr view, float radius)
     // dilate
     for (PointId i = 0; i < np; ++i)
     {
-        auto ids = neighborMap[i];
         double localMax(std::numeric_limits<double>::lowest());
-        for (auto const& j : ids)
+        for (auto const& j : neighbors.neighbors(i))
         {
             double z = minZ[j];
             if (z > localMax)
@@ -118,6 +129,67 @@ std::vector<double> PMFFilter::morphOpen(PointViewPtr view, float radius)
     return maxZ;
 }
 
+// Approximate the opening of each window with an opening of a raster of
+// minimum Z values.  Points are assigned to cells once, and each window is
+// opened with a disk whose radius is the window's half-width in cells, so
+// the cost of an iteration doesn't grow with the window size.
+std::vector<PointId> PMFFilter::rasterGround(PointViewPtr view,
+    const std::vector<float>& windowSizes,
+    const std::vector<float>& heightThresholds)
+{
+    using namespace Eigen;
+
+    point_count_t np(view->size());
+
+    BOX2D bounds;
+    view->calculateBounds(bounds);
+    int cols = static_cast<int>(
+        ceil((bounds.maxx - bounds.minx) / m_cellSize)) + 1;
+    int rows = static_cast<int>(
+        ceil((bounds.maxy - bounds.miny) / m_cellSize)) + 1;
+
+    std::vector<int> cells =
+        computeCells(*view, rows, cols, m_cellSize, bounds, threads());
+    std::vector<double> z(np);
+    view->getFieldsAs(Dimension::Id::Z, 0, np, z.data());
+
+    std::vector<PointId> groundIdx;
+    for (PointId i = 0; i < np; ++i)
+        groundIdx.push_back(i);
+
+    for (size_t j = 0; j < windowSizes.size(); ++j)
+    {
+        log()->get(LogLevel::Debug2) << "Iteration " << j <<
+            " (height threshold = " << heightThresholds[j] <<
+            ", window size = " << windowSizes[j] << ")\n";
+
+        // Rasterize the points currently considered ground returns.
+        MatrixXd ZImin = MatrixXd::Constant(rows, cols,
+            std::numeric_limits<double>::quiet_NaN());
+        for (PointId i : groundIdx)
+        {
+            double& cell = ZImin(cells[i]);
+            if (z[i] < cell || std::isnan(cell))
+                cell = z[i];
+        }
+
+        int radius = static_cast<int>(windowSizes[j] * 0.5 / m_cellSize);
+        MatrixXd minZ = erodeDisk(ZImin, radius, threads());
+        MatrixXd maxZ = dilateDisk(minZ, radius, threads());
+
+        std::vector<PointId> pt_indices;
+        for (PointId i : groundIdx)
+        {
+            float diff = z[i] - maxZ(cells[i]);
+            if (diff < heightThresholds[j])
+                pt_indices.push_back(i);
+        }
+        groundIdx.swap(pt_indices);
+    }
+
+    return groundIdx;
+}
+
 std::vector<PointId> PMFFilter::processGround(PointViewPtr view)
 {
     point_count_t np(view->size());
@@ -153,6 +225,9 @@ std::vector<PointId> PMFFilter::processGround(PointViewPtr view)
         iteration++;
     }
 
+    if (m_approximate)
+        return rasterGround(view, window_sizes, height_thresholds);
+
     std::vector<PointId> groundIdx;
     for (PointId i = 0; i < np; ++i)
         groundIdx.push_back(i);
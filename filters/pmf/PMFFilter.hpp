@@ -69,10 +69,16 @@ private:
     bool m_classify;
     bool m_extract;
     bool m_approximate;
+    std::string m_indexType;
+    bool m_useGrid;
 
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void addArgs(ProgramArgs& args);
+    virtual void initialize();
     std::vector<double> morphOpen(PointViewPtr view, float radius);
+    std::vector<PointId> rasterGround(PointViewPtr view,
+        const std::vector<float>& windowSizes,
+        const std::vector<float>& heightThresholds);
     std::vector<PointId> processGround(PointViewPtr view);
     virtual PointViewSet run(PointViewPtr view);
 
@@ -227,6 +227,40 @@ bool RangeFilter::processOne(PointRef& point)
 }
 
 
+// Same logic as processOne(), but each dimension is fetched for all the
+// points of the batch before its ranges are tested.
+point_count_t RangeFilter::processBatch(StreamPointTable& table,
+    point_count_t count, SkipMask& skips)
+{
+    PointRef point(table, 0);
+    std::vector<double> values(count);
+    std::vector<uint8_t> passes(count);
+
+    auto ri = m_range_list.begin();
+    while (ri != m_range_list.end())
+    {
+        Dimension::Id id = ri->m_id;
+        for (PointId idx = 0; idx < count; ++idx)
+        {
+            if (skips[idx])
+                continue;
+            point.setPointId(idx);
+            values[idx] = point.getFieldAs<double>(id);
+        }
+
+        std::fill(passes.begin(), passes.end(), 0);
+        for (; ri != m_range_list.end() && ri->m_id == id; ++ri)
+            for (PointId idx = 0; idx < count; ++idx)
+                passes[idx] |= dimensionPasses(values[idx], *ri);
+
+        for (PointId idx = 0; idx < count; ++idx)
+            if (!passes[idx])
+                skips[idx] = 1;
+    }
+    return count;
+}
+
+
 PointViewSet RangeFilter::run(PointViewPtr inView)
 {
     PointViewSet viewSet;
@@ -38,15 +38,31 @@
 #include <pdal/pdal_macros.hpp>
 #include <pdal/GDALUtils.hpp>
 #include <pdal/util/ProgramArgs.hpp>
+#include <pdal/util/ThreadPool.hpp>
 
 #include <gdal.h>
 #include <ogr_spatialref.h>
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
 
 namespace pdal
 {
 
+namespace
+{
+
+// Points transformed in each call to GDAL.  Coordinates are copied out of
+// the view this many at a time so that they stay in cache.
+const point_count_t BlockSize = 4096;
+
+// Points read from a view before the transformed coordinates are written
+// back to it.
+const point_count_t ChunkSize = 1 << 20;
+
+} // unnamed namespace
+
 static PluginInfo const s_info = PluginInfo(
     "filters.reprojection",
     "Reproject data using GDAL from one coordinate system to another.",
@@ -58,16 +74,15 @@ std::string ReprojectionFilter::getName() const { return s_info.name; }
 
 ReprojectionFilter::ReprojectionFilter()
     : m_inferInputSRS(true)
+    , m_maxError(0)
     , m_in_ref_ptr(NULL)
     , m_out_ref_ptr(NULL)
-    , m_transform_ptr(NULL)
     , m_errorHandler(new gdal::ErrorHandler())
 {}
 
 ReprojectionFilter::~ReprojectionFilter()
 {
-    if (m_transform_ptr)
-        OCTDestroyCoordinateTransformation(m_transform_ptr);
+    destroyTransforms();
     if (m_in_ref_ptr)
         OSRDestroySpatialReference(m_in_ref_ptr);
     if (m_out_ref_ptr)
@@ -79,6 +94,9 @@ void ReprojectionFilter::addArgs(ProgramArgs& args)
 {
     args.add("out_srs", "Output spatial reference", m_outSRS).setPositional();
     args.add("in_srs", "Input spatial reference", m_inSRS);
+    args.add("max_error", "Maximum error when interpolating transformed "
+        "coordinates in a grid.  Zero transforms every point exactly.",
+        m_maxError, 0.0);
 }
 
 
@@ -86,6 +104,13 @@ void ReprojectionFilter::initialize()
 {
     m_inferInputSRS = !m_inSRS.valid();
 
+    if (m_maxError < 0)
+    {
+        std::ostringstream oss;
+        oss << getName() << ": Option 'max_error' must not be negative.";
+        throw pdal_error(oss.str());
+    }
+
     m_out_ref_ptr = OSRNewSpatialReference(0);
     if (!m_out_ref_ptr)
         throw pdal::pdal_error("Unable to allocate new OSR SpatialReference "
@@ -106,6 +131,7 @@ void ReprojectionFilter::initialize()
 
 void ReprojectionFilter::ready(PointTableRef table)
 {
+    m_pool.reset(new ThreadPool(threads()));
     if (!table.supportsView())
         createTransform(table.anySpatialReference());
 }
@@ -143,31 +169,298 @@ void ReprojectionFilter::createTransform(const SpatialReference& srsSRS)
             "in the source file.";
         throw pdal_error(oss.str());
     }
-    if (m_transform_ptr)
-        OCTDestroyCoordinateTransformation(m_transform_ptr);
-    m_transform_ptr = OCTNewCoordinateTransformation(m_in_ref_ptr,
-        m_out_ref_ptr);
-    if (!m_transform_ptr)
+    destroyTransforms();
+    for (std::size_t i = 0; i < m_pool->numThreads(); ++i)
     {
-        std::ostringstream oss;
-        oss << getName() << ": Could not construct coordinate transformation object in createTransform";
-        throw pdal_error(oss.str());
+        TransformPtr transform = OCTNewCoordinateTransformation(m_in_ref_ptr,
+            m_out_ref_ptr);
+        if (!transform)
+        {
+            std::ostringstream oss;
+            oss << getName() << ": Could not construct coordinate transformation object in createTransform";
+            throw pdal_error(oss.str());
+        }
+        m_transforms.push_back(transform);
+    }
+}
+
+
+void ReprojectionFilter::destroyTransforms()
+{
+    for (TransformPtr transform : m_transforms)
+        OCTDestroyCoordinateTransformation(transform);
+    m_transforms.clear();
+}
+
+
+// Transform points in place.  Each entry of 'success' is set to zero for
+// a point that fails.
+void ReprojectionFilter::transform(point_count_t count, double *x,
+    double *y, double *z, int *success)
+{
+    if (m_maxError == 0 || !transformApprox(count, x, y, z, success))
+        transformExact(count, x, y, z, success);
+}
+
+
+// Transform points exactly, splitting them among the threads of the pool.
+//
+// Depending on the version of GDAL, OCTTransformEx may fail a whole block
+// when any of its points fails, without setting the success of the others
+// and with the coordinates partly transformed.  A block that fails is
+// restored and transformed again one point at a time.
+void ReprojectionFilter::transformExact(point_count_t count, double *x,
+    double *y, double *z, int *success)
+{
+    std::fill(success, success + count, 0);
+
+    const point_count_t numRanges =
+        (std::min)(count, (point_count_t)m_transforms.size());
+    for (point_count_t r = 0; r < numRanges; ++r)
+    {
+        const PointId begin = count * r / numRanges;
+        const PointId end = count * (r + 1) / numRanges;
+        TransformPtr t = m_transforms[r];
+        m_pool->add([=]()
+        {
+            std::vector<double> saved(BlockSize * 3);
+            for (PointId i = begin; i < end; i += BlockSize)
+            {
+                int n = (int)(std::min)(BlockSize, end - i);
+                std::copy(x + i, x + i + n, saved.begin());
+                std::copy(y + i, y + i + n, saved.begin() + n);
+                std::copy(z + i, z + i + n, saved.begin() + 2 * n);
+                if (OCTTransformEx(t, n, x + i, y + i, z + i, success + i))
+                    continue;
+
+                for (int j = 0; j < n; ++j)
+                {
+                    const PointId k = i + j;
+                    x[k] = saved[j];
+                    y[k] = saved[n + j];
+                    z[k] = saved[2 * n + j];
+                    success[k] = OCTTransform(t, 1, x + k, y + k, z + k);
+                }
+            }
+        });
+    }
+    m_pool->await();
+}
+
+// Transform points by interpolating in a grid of exactly transformed
+// points over their bounds.  Starting from a single cell, the grid is
+// refined until interpolating in it matches exact transformation within
+// the maximum error at the corners of a grid twice as fine: the midpoints
+// of the cells and their edges.  When the points span a range of Z, the
+// grid has a layer at the lowest and highest Z, and transformed
+// coordinates are taken to vary linearly between them, which is checked
+// at the middle Z.
+//
+// Returns false, leaving the points alone, when a grid point can't be
+// transformed or when the grid would need so many points that exact
+// transformation is cheaper.
+bool ReprojectionFilter::transformApprox(point_count_t count, double *x,
+    double *y, double *z, int *success)
+{
+    if (count == 0)
+        return false;
+
+    double minx = x[0], maxx = x[0];
+    double miny = y[0], maxy = y[0];
+    double minz = z[0], maxz = z[0];
+    for (point_count_t i = 1; i < count; ++i)
+    {
+        minx = (std::min)(minx, x[i]);
+        maxx = (std::max)(maxx, x[i]);
+        miny = (std::min)(miny, y[i]);
+        maxy = (std::max)(maxy, y[i]);
+        minz = (std::min)(minz, z[i]);
+        maxz = (std::max)(maxz, z[i]);
     }
+    if (!std::isfinite(maxx - minx) || !std::isfinite(maxy - miny) ||
+        !std::isfinite(maxz - minz))
+        return false;
+
+    const double width = maxx - minx;
+    const double height = maxy - miny;
+    const double depth = maxz - minz;
+    const int levels = depth > 0 ? 3 : 1;
+    const double zs[] = { minz, minz + depth / 2, maxz };
+
+    // Transformed corners of an n x n grid, one layer for each level of Z
+    // (lowest, middle, highest), stored by layer, row and column.
+    struct Grid
+    {
+        int n;
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<double> z;
+
+        std::size_t index(int layer, int row, int col) const
+            { return ((std::size_t)layer * (n + 1) + row) * (n + 1) + col; }
+    };
+
+    auto makeGrid = [&](int n, Grid& g)
+    {
+        const std::size_t size = (std::size_t)(n + 1) * (n + 1) * levels;
+        g.n = n;
+        g.x.resize(size);
+        g.y.resize(size);
+        g.z.resize(size);
+        for (int l = 0; l < levels; ++l)
+            for (int r = 0; r <= n; ++r)
+                for (int c = 0; c <= n; ++c)
+                {
+                    std::size_t i = g.index(l, r, c);
+                    g.x[i] = minx + width * c / n;
+                    g.y[i] = miny + height * r / n;
+                    g.z[i] = zs[levels == 1 ? 0 : l];
+                }
+        std::vector<int> ok(size);
+        transformExact(size, g.x.data(), g.y.data(), g.z.data(), ok.data());
+        return std::find(ok.begin(), ok.end(), 0) == ok.end();
+    };
+
+    // Bilinear interpolation in a layer of a grid at fractional row and
+    // column positions.
+    auto interp = [](const Grid& g, const std::vector<double>& v, int layer,
+        double row, double col)
+    {
+        const int r = (std::min)((int)row, g.n - 1);
+        const int c = (std::min)((int)col, g.n - 1);
+        const double tr = row - r;
+        const double tc = col - c;
+        const std::size_t i = g.index(layer, r, c);
+        const std::size_t j = i + g.n + 1;
+        return (v[i] * (1 - tc) + v[i + 1] * tc) * (1 - tr) +
+            (v[j] * (1 - tc) + v[j + 1] * tc) * tr;
+    };
+
+    auto close = [this](double a, double b)
+        { return std::fabs(a - b) <= m_maxError; };
+
+    // Check a grid against the one twice as fine.
+    auto fits = [&](const Grid& coarse, const Grid& fine)
+    {
+        const int top = levels - 1;
+        for (int r = 0; r <= fine.n; ++r)
+            for (int c = 0; c <= fine.n; ++c)
+            {
+                for (int l : { 0, top })
+                {
+                    std::size_t i = fine.index(l, r, c);
+                    if (!close(interp(coarse, coarse.x, l, r / 2.0, c / 2.0),
+                            fine.x[i]) ||
+                        !close(interp(coarse, coarse.y, l, r / 2.0, c / 2.0),
+                            fine.y[i]) ||
+                        !close(interp(coarse, coarse.z, l, r / 2.0, c / 2.0),
+                            fine.z[i]))
+                        return false;
+                }
+                if (levels == 1)
+                    continue;
+                std::size_t lo = fine.index(0, r, c);
+                std::size_t mid = fine.index(1, r, c);
+                std::size_t hi = fine.index(2, r, c);
+                if (!close((fine.x[lo] + fine.x[hi]) / 2, fine.x[mid]) ||
+                    !close((fine.y[lo] + fine.y[hi]) / 2, fine.y[mid]) ||
+                    !close((fine.z[lo] + fine.z[hi]) / 2, fine.z[mid]))
+                    return false;
+            }
+        return true;
+    };
+
+    Grid grid;
+    if (!makeGrid(1, grid))
+        return false;
+    while (true)
+    {
+        // Give up when the grid needs a good fraction as many exact
+        // transformations as there are points.
+        const int n = grid.n * 2;
+        if ((double)(n + 1) * (n + 1) * levels * 4 > count)
+            return false;
+        Grid fine;
+        if (!makeGrid(n, fine))
+            return false;
+        if (fits(grid, fine))
+            break;
+        grid = std::move(fine);
+    }
+
+    const double cellWidth = width > 0 ? width / grid.n : 1;
+    const double cellHeight = height > 0 ? height / grid.n : 1;
+    const int top = levels - 1;
+    auto apply = [&](PointId begin, PointId end)
+    {
+        for (PointId i = begin; i < end; ++i)
+        {
+            const double row = (y[i] - miny) / cellHeight;
+            const double col = (x[i] - minx) / cellWidth;
+            const double t = depth > 0 ? (z[i] - minz) / depth : 0;
+            x[i] = interp(grid, grid.x, 0, row, col) * (1 - t) +
+                interp(grid, grid.x, top, row, col) * t;
+            y[i] = interp(grid, grid.y, 0, row, col) * (1 - t) +
+                interp(grid, grid.y, top, row, col) * t;
+            z[i] = interp(grid, grid.z, 0, row, col) * (1 - t) +
+                interp(grid, grid.z, top, row, col) * t;
+            success[i] = 1;
+        }
+    };
+
+    const point_count_t numRanges =
+        (std::min)(count, (point_count_t)m_pool->numThreads());
+    for (point_count_t r = 0; r < numRanges; ++r)
+    {
+        const PointId begin = count * r / numRanges;
+        const PointId end = count * (r + 1) / numRanges;
+        m_pool->add([&apply, begin, end]() { apply(begin, end); });
+    }
+    m_pool->await();
+    return true;
 }
 
+
 PointViewSet ReprojectionFilter::run(PointViewPtr view)
 {
+    using namespace Dimension;
+
     PointViewSet viewSet;
     PointViewPtr outView = view->makeNew();
 
     createTransform(view->spatialReference());
 
-    PointRef point(*view, 0);
-    for (PointId id = 0; id < view->size(); ++id)
+    const point_count_t np = view->size();
+    const point_count_t chunkSize = (std::min)(np, ChunkSize);
+    std::vector<double> x(chunkSize);
+    std::vector<double> y(chunkSize);
+    std::vector<double> z(chunkSize);
+    std::vector<int> success(chunkSize);
+    for (PointId begin = 0; begin < np; begin += ChunkSize)
     {
-        point.setPointId(id);
-        if (processOne(point))
-            outView->appendPoint(*view, id);
+        const PointId end = (std::min)(begin + ChunkSize, np);
+        const point_count_t count = end - begin;
+        view->getFieldsAs(Id::X, begin, end, x.data());
+        view->getFieldsAs(Id::Y, begin, end, y.data());
+        view->getFieldsAs(Id::Z, begin, end, z.data());
+
+        transform(count, x.data(), y.data(), z.data(), success.data());
+
+        // Points that fail keep their coordinates and are dropped.
+        for (point_count_t i = 0; i < count; ++i)
+            if (!success[i])
+            {
+                x[i] = view->getFieldAs<double>(Id::X, begin + i);
+                y[i] = view->getFieldAs<double>(Id::Y, begin + i);
+                z[i] = view->getFieldAs<double>(Id::Z, begin + i);
+            }
+        view->setFields(Id::X, begin, end, x.data());
+        view->setFields(Id::Y, begin, end, y.data());
+        view->setFields(Id::Z, begin, end, z.data());
+
+        for (point_count_t i = 0; i < count; ++i)
+            if (success[i])
+                outView->appendPoint(*view, begin + i);
     }
 
     viewSet.insert(outView);
@@ -184,7 +477,7 @@ bool ReprojectionFilter::processOne(PointRef& point)
     double y(point.getFieldAs<double>(Dimension::Id::Y));
     double z(point.getFieldAs<double>(Dimension::Id::Z));
 
-    if (OCTTransform(m_transform_ptr, 1, &x, &y, &z))
+    if (OCTTransform(m_transforms[0], 1, &x, &y, &z))
     {
         point.setField(Dimension::Id::X, x);
         point.setField(Dimension::Id::Y, y);
@@ -198,4 +491,45 @@ bool ReprojectionFilter::processOne(PointRef& point)
     }
 }
 
+
+point_count_t ReprojectionFilter::processBatch(StreamPointTable& table,
+    point_count_t count, SkipMask& skips)
+{
+    using namespace Dimension;
+
+    // Gather the points that haven't been skipped.
+    PointRef point(table, 0);
+    std::vector<PointId> ids;
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+    for (PointId idx = 0; idx < count; ++idx)
+    {
+        if (skips[idx])
+            continue;
+        point.setPointId(idx);
+        ids.push_back(idx);
+        x.push_back(point.getFieldAs<double>(Id::X));
+        y.push_back(point.getFieldAs<double>(Id::Y));
+        z.push_back(point.getFieldAs<double>(Id::Z));
+    }
+
+    std::vector<int> success(ids.size());
+    transform(ids.size(), x.data(), y.data(), z.data(), success.data());
+
+    for (std::size_t i = 0; i < ids.size(); ++i)
+    {
+        if (!success[i])
+        {
+            skips[ids[i]] = 1;
+            continue;
+        }
+        point.setPointId(ids[i]);
+        point.setField(Id::X, x[i]);
+        point.setField(Id::Y, y[i]);
+        point.setField(Id::Z, z[i]);
+    }
+    return count;
+}
+
 } // namespace pdal
@@ -38,6 +38,7 @@
 #include <pdal/Filter.hpp>
 
 #include <memory>
+#include <vector>
 
 extern "C" int32_t ReprojectionFilter_ExitFunc();
 extern "C" PF_ExitFunc ReprojectionFilter_InitPlugin();
@@ -50,6 +51,8 @@ namespace gdal
     class ErrorHandler;
 }
 
+class ThreadPool;
+
 class PDAL_DLL ReprojectionFilter : public Filter
 {
 public:
@@ -65,20 +68,35 @@ private:
     virtual void initialize();
     virtual void ready(PointTableRef table);
     virtual PointViewSet run(PointViewPtr view);
+    virtual bool streamable() const
+        { return true; }
     virtual bool processOne(PointRef& point);
+    virtual point_count_t processBatch(StreamPointTable& table,
+        point_count_t count, SkipMask& skips);
 
     void updateBounds();
     void createTransform(const SpatialReference& srs);
+    void destroyTransforms();
+    void transform(point_count_t count, double *x, double *y, double *z,
+        int *success);
+    void transformExact(point_count_t count, double *x, double *y,
+        double *z, int *success);
+    bool transformApprox(point_count_t count, double *x, double *y,
+        double *z, int *success);
 
     SpatialReference m_inSRS;
     SpatialReference m_outSRS;
     bool m_inferInputSRS;
+    double m_maxError;
 
     typedef void* ReferencePtr;
     typedef void* TransformPtr;
     ReferencePtr m_in_ref_ptr;
     ReferencePtr m_out_ref_ptr;
-    TransformPtr m_transform_ptr;
+    // One transformation for each thread of the pool, as they can't be
+    // shared between threads.
+    std::vector<TransformPtr> m_transforms;
+    std::unique_ptr<ThreadPool> m_pool;
     gdal::ErrorHandler* m_errorHandler;
 
     ReprojectionFilter& operator=(const ReprojectionFilter&); // not implemented
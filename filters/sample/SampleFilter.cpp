@@ -34,11 +34,15 @@
 
 #include "SampleFilter.hpp"
 
+#include <pdal/GridIndex.hpp>
 #include <pdal/KDIndex.hpp>
 #include <pdal/util/Utils.hpp>
 #include <pdal/pdal_macros.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 
+#include <algorithm>
+#include <ctime>
+#include <random>
 #include <string>
 #include <vector>
 
@@ -60,36 +64,36 @@ std::string SampleFilter::getName() const
 void SampleFilter::addArgs(ProgramArgs& args)
 {
     args.add("radius", "Radius", m_radius, 1.0);
+    addIndexArg(args, m_indexType);
 }
 
 
-void SampleFilter::addDimensions(PointLayoutPtr layout)
+void SampleFilter::initialize()
 {
-    layout->registerDim(Dimension::Id::Classification);
+    m_useGrid = (parseIndexType(getName(), m_indexType) == IndexType::Grid);
 }
 
 
-PointViewSet SampleFilter::run(PointViewPtr inView)
+void SampleFilter::addDimensions(PointLayoutPtr layout)
 {
-    point_count_t np = inView->size();
+    layout->registerDim(Dimension::Id::Classification);
+}
 
-    // Return empty PointViewSet if the input PointView has no points.
-    // Otherwise, make a new output PointView.
-    PointViewSet viewSet;
-    if (!np)
-        return viewSet;
-    PointViewPtr outView = inView->makeNew();
 
-    // Build the 3D KD-tree.
-    KD3Index index(*inView);
-    index.build();
+template<typename INDEX>
+void SampleFilter::sample(PointView& inView, PointView& outView,
+    const INDEX& index)
+{
+    point_count_t np = inView.size();
 
     // The result looks much better if we take some time to shuffle the indices.
-    std::srand(std::time(NULL));
+    // Each call has its own generator since views may be sampled
+    // concurrently.
+    std::mt19937 gen(static_cast<std::mt19937::result_type>(std::time(NULL)));
     std::vector<PointId> indices(np);
     for (PointId i = 0; i < np; ++i)
         indices[i] = i;
-    std::random_shuffle(indices.begin(), indices.end());
+    std::shuffle(indices.begin(), indices.end(), gen);
 
     // All points are marked as kept (1) by default. As they are masked by
     // neighbors within the user-specified radius, their value is changed to 0.
@@ -103,17 +107,39 @@ PointViewSet SampleFilter::run(PointViewPtr inView)
         // PointView.
         if (keep[i] == 0)
             continue;
-        outView->appendPoint(*inView, i);
+        outView.appendPoint(inView, i);
 
         // We now proceed to mask all neighbors within m_radius of the kept
         // point.
-        double x = inView->getFieldAs<double>(Dimension::Id::X, i);
-        double y = inView->getFieldAs<double>(Dimension::Id::Y, i);
-        double z = inView->getFieldAs<double>(Dimension::Id::Z, i);
+        double x = inView.getFieldAs<double>(Dimension::Id::X, i);
+        double y = inView.getFieldAs<double>(Dimension::Id::Y, i);
+        double z = inView.getFieldAs<double>(Dimension::Id::Z, i);
         auto ids = index.radius(x, y, z, m_radius);
         for (PointId j = 1; j < ids.size(); ++j)
             keep[ids[j]] = 0;
     }
+}
+
+
+PointViewSet SampleFilter::run(PointViewPtr inView)
+{
+    point_count_t np = inView->size();
+
+    // Return empty PointViewSet if the input PointView has no points.
+    // Otherwise, make a new output PointView.
+    PointViewSet viewSet;
+    if (!np)
+        return viewSet;
+    PointViewPtr outView = inView->makeNew();
+
+    if (m_useGrid)
+    {
+        Grid3Index index(*inView, m_radius);
+        index.build(threads());
+        sample(*inView, *outView, index);
+    }
+    else
+        sample(*inView, *outView, inView->build3dIndex(threads()));
 
     // Simply calculate the percentage of retained points.
     double frac = (double)outView->size() / (double)inView->size();
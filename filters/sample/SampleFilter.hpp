@@ -61,9 +61,16 @@ public:
 
 private:
     double m_radius;
+    std::string m_indexType;
+    bool m_useGrid;
 
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void addArgs(ProgramArgs& args);
+    virtual void initialize();
+    template<typename INDEX>
+    void sample(PointView& inView, PointView& outView, const INDEX& index);
+    virtual bool parallelSafe() const
+        { return true; }
     virtual PointViewSet run(PointViewPtr view);
 };
 
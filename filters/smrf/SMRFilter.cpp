@@ -39,10 +39,13 @@
 #include <pdal/PipelineManager.hpp>
 #include <buffer/BufferReader.hpp>
 #include <pdal/util/ProgramArgs.hpp>
+#include <pdal/util/ThreadPool.hpp>
 
 #include <Eigen/Dense>
 #include <Eigen/Sparse>
 
+#include <atomic>
+
 #include "gdal_priv.h" // For File I/O
 #include "gdal_version.h" // For version info
 #include "ogr_spatialref.h"  //For Geographic Information/Transformations
@@ -111,56 +114,9 @@ MatrixXd SMRFilter::matrixOpen(MatrixXd data, int radius)
 {
     MatrixXd data2 = padMatrix(data, radius);
 
-    int nrows = data2.rows();
-    int ncols = data2.cols();
-
     // first min, then max of min
-    MatrixXd minZ = MatrixXd::Constant(nrows, ncols,
-                                       std::numeric_limits<double>::max());
-    MatrixXd maxZ = MatrixXd::Constant(nrows, ncols,
-                                       std::numeric_limits<double>::lowest());
-    for (int c = 0; c < ncols; ++c)
-    {
-        for (int r = 0; r < nrows; ++r)
-        {
-            int cs = clamp(c-radius, 0, ncols-1);
-            int ce = clamp(c+radius, 0, ncols-1);
-            int rs = clamp(r-radius, 0, nrows-1);
-            int re = clamp(r+radius, 0, nrows-1);
-
-            for (int col = cs; col <= ce; ++col)
-            {
-                for (int row = rs; row <= re; ++row)
-                {
-                    if ((row-r)*(row-r)+(col-c)*(col-c) > radius*radius)
-                        continue;
-                    if (data2(row, col) < minZ(r, c))
-                        minZ(r, c) = data2(row, col);
-                }
-            }
-        }
-    }
-    for (int c = 0; c < ncols; ++c)
-    {
-        for (int r = 0; r < nrows; ++r)
-        {
-            int cs = clamp(c-radius, 0, ncols-1);
-            int ce = clamp(c+radius, 0, ncols-1);
-            int rs = clamp(r-radius, 0, nrows-1);
-            int re = clamp(r+radius, 0, nrows-1);
-
-            for (int col = cs; col <= ce; ++col)
-            {
-                for (int row = rs; row <= re; ++row)
-                {
-                    if ((row-r)*(row-r)+(col-c)*(col-c) > radius*radius)
-                        continue;
-                    if (minZ(row, col) > maxZ(r, c))
-                        maxZ(r, c) = minZ(row, col);
-                }
-            }
-        }
-    }
+    MatrixXd minZ = erodeDisk(data2, radius, threads());
+    MatrixXd maxZ = dilateDisk(minZ, radius, threads());
 
     return maxZ.block(radius, radius, data.rows(), data.cols());
 }
@@ -830,16 +786,13 @@ MatrixXd SMRFilter::TPS(MatrixXd cx, MatrixXd cy, MatrixXd cz)
     return S;
 }
 
-MatrixXd SMRFilter::expandingTPS(MatrixXd cx, MatrixXd cy, MatrixXd cz)
+// Fill the empty cells of S in columns [first, last) from the cells of cz
+// around them.
+void SMRFilter::expandingTPSColumns(const MatrixXd& cx, const MatrixXd& cy,
+    const MatrixXd& cz, MatrixXd& S, int first, int last,
+    std::atomic<int>& num_nan_detect, std::atomic<int>& num_nan_replace)
 {
-    log()->get(LogLevel::Info) << "TPS: Reticulating splines...\n";
-
-    MatrixXd S = cz;
-
-    int num_nan_detect(0);
-    int num_nan_replace(0);
-
-    for (auto outer_col = 0; outer_col < m_numCols; ++outer_col)
+    for (auto outer_col = first; outer_col < last; ++outer_col)
     {
         for (auto outer_row = 0; outer_row < m_numRows; ++outer_row)
         {
@@ -856,7 +809,6 @@ MatrixXd SMRFilter::expandingTPS(MatrixXd cx, MatrixXd cy, MatrixXd cz)
 
             while (!solution)
             {
-                // std::cerr << radius;
                 int cs = clamp(outer_col-radius, 0, m_numCols-1);
                 int ce = clamp(outer_col+radius, 0, m_numCols-1);
                 int col_size = ce - cs + 1;
@@ -931,66 +883,41 @@ MatrixXd SMRFilter::expandingTPS(MatrixXd cx, MatrixXd cy, MatrixXd cz)
 
                 if (!solution)
                 {
-                    std::cerr << "..." << radius << std::endl;;
                     ++radius;
                     continue;
                 }
 
                 S(outer_row, outer_col) = val;
                 num_nan_replace++;
-
-                // std::cerr << std::endl;
-
-                // std::cerr << std::fixed;
-                // std::cerr << std::setprecision(3)
-                //           << std::left
-                //           << "S(" << outer_row << "," << outer_col << "): "
-                //           << std::setw(10)
-                //           << S(outer_row, outer_col)
-                //           // << std::setw(3)
-                //           // << "\tz: "
-                //           // << std::setw(10)
-                //           // << zi
-                //           // << std::setw(7)
-                //           // << "\tzdiff: "
-                //           // << std::setw(5)
-                //           // << zi - S(outer_row, outer_col)
-                //           // << std::setw(7)
-                //           // << "\txdiff: "
-                //           // << std::setw(5)
-                //           // << xi2 - xi
-                //           // << std::setw(7)
-                //           // << "\tydiff: "
-                //           // << std::setw(5)
-                //           // << yi2 - yi
-                //           << std::setw(7)
-                //           << "\t# pts: "
-                //           << std::setw(3)
-                //           << nsize
-                //           << std::setw(5)
-                //           << "\tsum: "
-                //           << std::setw(10)
-                //           << sum
-                //           << std::setw(9)
-                //           << "\tw.sum(): "
-                //           << std::setw(5)
-                //           << w.sum()
-                //           << std::setw(6)
-                //           << "\txsum: "
-                //           << std::setw(5)
-                //           << w.dot(P.col(1))
-                //           << std::setw(6)
-                //           << "\tysum: "
-                //           << std::setw(5)
-                //           << w.dot(P.col(2))
-                //           << std::setw(3)
-                //           << "\ta: "
-                //           << std::setw(8)
-                //           << a.transpose()
-                //           << std::endl;
             }
         }
     }
+}
+
+MatrixXd SMRFilter::expandingTPS(MatrixXd cx, MatrixXd cy, MatrixXd cz)
+{
+    log()->get(LogLevel::Info) << "TPS: Reticulating splines...\n";
+
+    MatrixXd S = cz;
+
+    std::atomic<int> num_nan_detect(0);
+    std::atomic<int> num_nan_replace(0);
+
+    // Each cell is filled from the cells of cz around it, so bands of
+    // columns can be filled in parallel.
+    ThreadPool pool(threads());
+    const int numBands = (std::min)(m_numCols, (int)pool.numThreads() * 4);
+    for (int band = 0; band < numBands; ++band)
+    {
+        const int first = m_numCols * band / numBands;
+        const int last = m_numCols * (band + 1) / numBands;
+        pool.add([&, first, last]()
+        {
+            expandingTPSColumns(cx, cy, cz, S, first, last, num_nan_detect,
+                num_nan_replace);
+        });
+    }
+    pool.await();
 
     double frac = static_cast<double>(num_nan_replace);
     frac /= static_cast<double>(num_nan_detect);
@@ -39,6 +39,7 @@
 
 #include <Eigen/Dense>
 
+#include <atomic>
 #include <memory>
 #include <unordered_map>
 
@@ -110,6 +111,9 @@ private:
     // TPS returns an interpolated matrix using thin plate splines.
     MatrixXd TPS(MatrixXd cx, MatrixXd cy, MatrixXd cz);
     MatrixXd expandingTPS(MatrixXd cx, MatrixXd cy, MatrixXd cz);
+    void expandingTPSColumns(const MatrixXd& cx, const MatrixXd& cy,
+        const MatrixXd& cz, MatrixXd& S, int first, int last,
+        std::atomic<int>& num_nan_detect, std::atomic<int>& num_nan_replace);
 
     // writeMatrix writes out Eigen matrices to GeoTIFFs for debugging.
     void writeMatrix(MatrixXd data, std::string filename,
@@ -70,6 +70,8 @@ private:
     virtual void ready(PointTableRef table)
         { m_dim = table.layout()->findDim(m_dimName); }
 
+    virtual bool parallelSafe() const
+        { return true; }
     virtual void filter(PointView& view)
     {
         if (m_dim == Dimension::Id::Unknown)
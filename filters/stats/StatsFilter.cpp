@@ -111,6 +111,26 @@ bool StatsFilter::processOne(PointRef& point)
 }
 
 
+point_count_t StatsFilter::processBatch(StreamPointTable& table,
+    point_count_t count, SkipMask& skips)
+{
+    PointRef point(table, 0);
+    for (auto p = m_stats.begin(); p != m_stats.end(); ++p)
+    {
+        Dimension::Id d = p->first;
+        Summary& c = p->second;
+        for (PointId idx = 0; idx < count; ++idx)
+        {
+            if (skips[idx])
+                continue;
+            point.setPointId(idx);
+            c.insert(point.getFieldAs<double>(d));
+        }
+    }
+    return count;
+}
+
+
 void StatsFilter::filter(PointView& view)
 {
     PointRef point(view, 0);
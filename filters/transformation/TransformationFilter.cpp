@@ -36,7 +36,9 @@
 
 #include <pdal/pdal_export.hpp>
 #include <pdal/pdal_macros.hpp>
+#include <pdal/util/Affine.hpp>
 
+#include <algorithm>
 #include <sstream>
 
 namespace pdal
@@ -115,13 +117,72 @@ bool TransformationFilter::processOne(PointRef& point)
 }
 
 
-void TransformationFilter::filter(PointView& view)
+point_count_t TransformationFilter::processBatch(StreamPointTable& table,
+    point_count_t count, SkipMask& skips)
 {
-    PointRef point(view, 0);
-    for (PointId idx = 0; idx < view.size(); ++idx)
+    PointRef point(table, 0);
+    std::vector<double> x(count);
+    std::vector<double> y(count);
+    std::vector<double> z(count);
+
+    for (PointId idx = 0; idx < count; ++idx)
     {
+        if (skips[idx])
+            continue;
         point.setPointId(idx);
-        processOne(point);
+        x[idx] = point.getFieldAs<double>(Dimension::Id::X);
+        y[idx] = point.getFieldAs<double>(Dimension::Id::Y);
+        z[idx] = point.getFieldAs<double>(Dimension::Id::Z);
+    }
+
+    affineTransform(m_matrix.data(), count, x.data(), y.data(), z.data());
+
+    for (PointId idx = 0; idx < count; ++idx)
+    {
+        if (skips[idx])
+            continue;
+        point.setPointId(idx);
+        point.setField(Dimension::Id::X, x[idx]);
+        point.setField(Dimension::Id::Y, y[idx]);
+        point.setField(Dimension::Id::Z, z[idx]);
+    }
+    return count;
+}
+
+
+void TransformationFilter::filter(PointView& view)
+{
+    using namespace Dimension;
+
+    // Transform in place when the coordinates are stored as columns.
+    if (view.hasColumn<double>(Id::X) && view.hasColumn<double>(Id::Y) &&
+        view.hasColumn<double>(Id::Z))
+    {
+        auto xs = view.column<double>(Id::X);
+        auto ys = view.column<double>(Id::Y);
+        auto zs = view.column<double>(Id::Z);
+        for (std::size_t i = 0; i < xs.size(); ++i)
+            affineTransform(m_matrix.data(), xs[i].size(), xs[i].data(),
+                ys[i].data(), zs[i].data());
+        return;
+    }
+
+    // Otherwise copy the coordinates out and back in blocks.
+    const point_count_t BlockSize = 4096;
+    std::vector<double> x(BlockSize);
+    std::vector<double> y(BlockSize);
+    std::vector<double> z(BlockSize);
+    for (PointId begin = 0; begin < view.size(); begin += BlockSize)
+    {
+        const PointId end = (std::min)(begin + BlockSize, view.size());
+        view.getFieldsAs(Id::X, begin, end, x.data());
+        view.getFieldsAs(Id::Y, begin, end, y.data());
+        view.getFieldsAs(Id::Z, begin, end, z.data());
+        affineTransform(m_matrix.data(), end - begin, x.data(), y.data(),
+            z.data());
+        view.setFields(Id::X, begin, end, x.data());
+        view.setFields(Id::Y, begin, end, y.data());
+        view.setFields(Id::Z, begin, end, z.data());
     }
 }
 
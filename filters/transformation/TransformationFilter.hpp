@@ -71,7 +71,13 @@ private:
 
     virtual void addArgs(ProgramArgs& args);
     virtual void initialize();
+    virtual bool streamable() const
+        { return true; }
     virtual bool processOne(PointRef& point);
+    virtual point_count_t processBatch(StreamPointTable& table,
+        point_count_t count, SkipMask& skips);
+    virtual bool parallelSafe() const
+        { return true; }
     virtual void filter(PointView& view);
 
     std::string m_matrixSpec;
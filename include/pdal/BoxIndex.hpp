@@ -0,0 +1,93 @@
+/******************************************************************************
+* Copyright (c) 2016, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <pdal/pdal_internal.hpp>
+#include <pdal/util/Bounds.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace pdal
+{
+
+/**
+  A static R-tree over a set of 2D boxes, packed with the Sort-Tile-
+  Recursive algorithm.  It finds the boxes that contain a point in time
+  logarithmic in the number of boxes, which lets a point be tested against
+  only the nearby members of a large set of regions.
+*/
+class PDAL_DLL BoxIndex
+{
+public:
+    /**
+      Build an index of boxes.
+
+      \param boxes  Boxes to index.  Boxes are identified in queries by
+        their position in this vector.
+    */
+    BoxIndex(const std::vector<BOX2D>& boxes);
+
+    /**
+      Find the boxes that contain a point, including on their edges.
+
+      \param x  X coordinate of the point.
+      \param y  Y coordinate of the point.
+      \param[out] ids  Cleared, then filled with the positions of the
+        boxes that contain the point, in no particular order.
+    */
+    void query(double x, double y, std::vector<uint32_t>& ids) const;
+
+private:
+    struct Node
+    {
+        BOX2D m_bounds;
+        // Children of a leaf are boxes at positions [m_first,
+        // m_first + m_count) of m_items.  Those of other nodes are nodes
+        // at the same positions of m_nodes.
+        uint32_t m_first;
+        uint32_t m_count;
+    };
+
+    std::vector<BOX2D> m_boxes;
+    std::vector<uint32_t> m_items;
+    std::vector<Node> m_nodes;
+    uint32_t m_numLeaves;
+
+    void query(uint32_t node, double x, double y,
+        std::vector<uint32_t>& ids) const;
+};
+
+} // namespace pdal
@@ -52,6 +52,7 @@
 #include <pdal/util/OStream.hpp>
 
 #include <map>
+#include <sstream>
 #include <vector>
 
 namespace pdal
@@ -213,7 +214,7 @@ public:
         uint32_t chunksize) :
         m_stream(stream), m_outputStream(stream), m_schema(schema),
         m_chunksize(chunksize), m_chunkPointsWritten(0), m_chunkInfoPos(0),
-        m_chunkOffset(0)
+        m_chunkOffset(0), m_started(false)
     {}
 
     ~LazPerfVlrCompressor()
@@ -224,16 +225,16 @@ public:
     }
 
 
+    uint32_t chunkSize() const
+        { return m_chunksize; }
+
     void compress(const char *inbuf)
     {
         // First time through.
         if (!m_encoder || !m_compressor)
         {
-            // Get the position
-            m_chunkInfoPos = m_stream.tellp();
-            // Seek over the chunk info offset value
-            m_stream.seekp(sizeof(uint64_t), std::ios::cur);
-            m_chunkOffset = m_stream.tellp();
+            if (!m_started)
+                start();
             resetCompressor();
         }
         else if (m_chunkPointsWritten == m_chunksize)
@@ -245,13 +246,65 @@ public:
         m_chunkPointsWritten++;
     }
 
-    void done()
+    /**
+      Compress points into a standalone chunk.  Doesn't touch the output
+      stream, so chunks may be compressed on several threads at once.
+      \param inbuf  Packed points to compress.
+      \param numPts  Number of points to compress.  Must be no more than
+        the chunk size.
+      \param pointLen  Length of a packed point.
+      \return  Compressed chunk to be passed to \ref writeChunk.
+    */
+    std::string compressChunk(const char *inbuf, point_count_t numPts,
+        size_t pointLen) const
     {
-        // Close and clear the point encoder.
-        m_encoder->done();
-        m_encoder.reset();
+        std::ostringstream chunkStream(std::ios::out | std::ios::binary);
+        OutputStream outputStream(chunkStream);
+        Encoder encoder(outputStream);
+        Compressor::ptr compressor =
+            laszip::factory::build_compressor(encoder, m_schema);
+        for (point_count_t i = 0; i < numPts; ++i)
+        {
+            compressor->compress(inbuf);
+            inbuf += pointLen;
+        }
+        encoder.done();
+        return chunkStream.str();
+    }
 
+    /**
+      Write a chunk returned by \ref compressChunk.  All chunks but the
+      last must hold exactly the chunk size number of points.
+      \param chunk  Compressed chunk.
+    */
+    void writeChunk(const std::string& chunk)
+    {
+        if (!m_started)
+            start();
+
+        // Close any chunk started with compress().
+        if (m_encoder)
+        {
+            m_encoder->done();
+            m_encoder.reset();
+            newChunk();
+        }
+        m_stream.write(chunk.data(), chunk.size());
         newChunk();
+    }
+
+    void done()
+    {
+        if (!m_started)
+            start();
+
+        // Close and clear the point encoder.
+        if (m_encoder)
+        {
+            m_encoder->done();
+            m_encoder.reset();
+            newChunk();
+        }
 
         // Save our current position.  Go to the location where we need
         // to write the chunk table offset at the beginning of the point data.
@@ -284,6 +337,16 @@ public:
     }
 
 private:
+    void start()
+    {
+        // Get the position
+        m_chunkInfoPos = m_stream.tellp();
+        // Seek over the chunk info offset value
+        m_stream.seekp(sizeof(uint64_t), std::ios::cur);
+        m_chunkOffset = m_stream.tellp();
+        m_started = true;
+    }
+
     void resetCompressor()
     {
         if (m_encoder)
@@ -310,6 +373,7 @@ private:
     std::streampos m_chunkInfoPos;
     std::streampos m_chunkOffset;
     std::vector<uint32_t> m_chunkTable;
+    bool m_started;
 };
 
 
@@ -39,11 +39,13 @@
 
 #include <Eigen/Dense>
 
+#include <cmath>
 #include <vector>
 
 namespace pdal
 {
 class PointView;
+struct NeighborTable;
 
 /**
  * \brief Compute the centroid of a collection of points.
@@ -70,7 +72,8 @@ class PointView;
  * \param ids a vector of PointIds specifying a subset of points.
  * \return the 3D centroid of the XYZ dimensions.
  */
-PDAL_DLL Eigen::Vector3f computeCentroid(PointView& view, std::vector<PointId> ids);
+PDAL_DLL Eigen::Vector3f computeCentroid(PointView& view,
+    const std::vector<PointId>& ids);
 
 /**
  * \brief Compute the covariance matrix of a collection of points.
@@ -97,7 +100,8 @@ PDAL_DLL Eigen::Vector3f computeCentroid(PointView& view, std::vector<PointId> i
  * \param ids a vector of PointIds specifying a subset of points.
  * \return the covariance matrix of the XYZ dimensions.
  */
-PDAL_DLL Eigen::Matrix3f computeCovariance(PointView& view, std::vector<PointId> ids);
+PDAL_DLL Eigen::Matrix3f computeCovariance(PointView& view,
+    const std::vector<PointId>& ids);
 
 /**
  * \brief Compute the rank of a collection of points.
@@ -131,10 +135,131 @@ PDAL_DLL Eigen::Matrix3f computeCovariance(PointView& view, std::vector<PointId>
  * \param ids a vector of PointIds specifying a subset of points.
  * \return the estimated rank.
  */
-PDAL_DLL uint8_t computeRank(PointView& view, std::vector<PointId> ids, double threshold);
+PDAL_DLL uint8_t computeRank(PointView& view,
+    const std::vector<PointId>& ids, double threshold);
+
+/**
+ * \brief Eigen decomposition of the covariance of a neighborhood.
+ *
+ * The eigenvalues are those of the (unnormalized) covariance returned by
+ * \ref computeCovariance, sorted in ascending order.  The normal is the
+ * unit eigenvector of the smallest eigenvalue; its sign is arbitrary.
+ * The remaining features are the usual dimensionality measures derived
+ * from the eigenvalues, and are zero for a degenerate neighborhood.
+ */
+struct EigenFeatures
+{
+    Eigen::Vector3d values;
+    Eigen::Vector3d normal;
+
+    /// Surface variation: lambda0 / (lambda0 + lambda1 + lambda2).
+    double curvature() const
+    {
+        double sum = values[0] + values[1] + values[2];
+        return sum != 0 ? std::fabs(values[0] / sum) : 0;
+    }
+
+    /// Linearity: (lambda2 - lambda1) / lambda2.
+    double linearity() const
+        { return values[2] != 0 ? (values[2] - values[1]) / values[2] : 0; }
+
+    /// Planarity: (lambda1 - lambda0) / lambda2.
+    double planarity() const
+        { return values[2] != 0 ? (values[1] - values[0]) / values[2] : 0; }
+
+    /// Scattering: lambda0 / lambda2.
+    double scattering() const
+        { return values[2] != 0 ? values[0] / values[2] : 0; }
+};
+
+/**
+ * \brief Compute the eigen features of many neighborhoods at once.
+ *
+ * The coordinates of the view are read once into a contiguous array, from
+ * which the covariance of each neighborhood is computed in double
+ * precision.  Each 3x3 covariance is decomposed
+ * with Eigen's closed-form solver (SelfAdjointEigenSolver::computeDirect)
+ * rather than the iterative one.  Ranges of query points are processed in
+ * parallel.
+ *
+ * \code
+ * KD3Index& kdi = view.build3dIndex();
+ * NeighborTable neighbors = kdi.knnAll(8);
+ * std::vector<EigenFeatures> features =
+ *     computeEigenFeatures(view, neighbors);
+ * \endcode
+ *
+ * \param view the source PointView.
+ * \param neighbors neighborhoods, as ids of points of the view.
+ * \param threads number of threads to use.  Zero means all hardware threads.
+ * \return the features of each query point of the neighbor table.
+ */
+PDAL_DLL std::vector<EigenFeatures> computeEigenFeatures(
+    const PointView& view, const NeighborTable& neighbors,
+    std::size_t threads = 1);
 
 // createDSM returns a matrix with minimum Z values from the provided
 // PointView.
 PDAL_DLL Eigen::MatrixXd createDSM(PointView& view, int rows, int cols,
                                    double cell_size, BOX2D bounds);
+
+/**
+ * \brief Find the raster cell of each point of a view.
+ *
+ * Cells are laid out as in \ref createDSM: columns run east from
+ * bounds.minx, rows run south from the top of the raster and points
+ * outside the raster are clamped to its edge.  Cell indices are in
+ * column-major order (row + column * rows), matching Eigen's default
+ * storage, so they can be used directly as indices of a matrix.
+ *
+ * Assigning points to cells once lets filters that rasterize the same
+ * points many times avoid recomputing it.
+ *
+ * \param view points to assign.
+ * \param rows number of rows in the raster.
+ * \param cols number of columns in the raster.
+ * \param cell_size edge length of a cell.
+ * \param bounds bounds of the raster.
+ * \param threads number of threads to use.  Zero means all hardware threads.
+ * \return the cell index of each point of the view.
+ */
+PDAL_DLL std::vector<int> computeCells(PointView& view, int rows, int cols,
+                                       double cell_size, BOX2D bounds,
+                                       std::size_t threads = 1);
+
+/**
+ * \brief Erode a raster with a disk-shaped structuring element.
+ *
+ * Each cell of the result is the minimum of the cells of the input within
+ * \p radius cells of it (a cell (r, c) is within the disk when
+ * r * r + c * c <= radius * radius).  NaN cells are ignored.  A cell whose
+ * disk holds only NaN cells is set to the largest double.
+ *
+ * The disk is split into vertical line segments, and the minimum along
+ * each segment is found with the van Herk/Gil-Werman algorithm, so the
+ * cost per cell grows linearly with the radius rather than with its
+ * square.  Bands of columns are processed in parallel.
+ *
+ * \param data the input raster.
+ * \param radius radius of the disk, in cells.
+ * \param threads number of threads to use.  Zero means all hardware threads.
+ * \return the eroded raster.
+ */
+PDAL_DLL Eigen::MatrixXd erodeDisk(const Eigen::MatrixXd& data, int radius,
+                                   std::size_t threads = 1);
+
+/**
+ * \brief Dilate a raster with a disk-shaped structuring element.
+ *
+ * As \ref erodeDisk, but each cell of the result is the maximum of the
+ * cells of the input within the disk.  A cell whose disk holds only NaN
+ * cells is set to the lowest double.
+ *
+ * \param data the input raster.
+ * \param radius radius of the disk, in cells.
+ * \param threads number of threads to use.  Zero means all hardware threads.
+ * \return the dilated raster.
+ */
+PDAL_DLL Eigen::MatrixXd dilateDisk(const Eigen::MatrixXd& data, int radius,
+                                    std::size_t threads = 1);
 } // namespace pdal
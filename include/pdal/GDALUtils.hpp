@@ -42,7 +42,9 @@
 
 #include <array>
 #include <functional>
+#include <list>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
 #include <cpl_port.h>
@@ -259,6 +261,40 @@ public:
     void close();
 
     GDALError read(double x, double y, std::vector<double>& data);
+
+    /**
+      Read the values of all bands at a batch of locations.  Locations
+      are visited in raster block order and each block is read once, for
+      all bands, into a block cache (see setCacheSize()).
+
+      \param x  X coordinates of the locations.
+      \param y  Y coordinates of the locations.
+      \param count  Number of locations.
+      \param data  Vector into which band values are read.  The values
+        for location i are at [i * band count, (i + 1) * band count).
+        The vector is resized as necessary.
+      \param valid  Set to 1 for locations that fall within the raster
+        and 0 for those that don't.  The vector is resized as necessary.
+      \param bilinear  Interpolate between the four nearest pixel centers
+        rather than taking the value of the pixel containing the location.
+        A band takes the value of the containing pixel instead if any of
+        the four pixels has that band's nodata value.
+      \return  GDALError::None on success, GDALError::CantReadBlock if a
+        block couldn't be read.
+    */
+    GDALError read(const double *x, const double *y, std::size_t count,
+        std::vector<double>& data, std::vector<uint8_t>& valid,
+        bool bilinear = false);
+
+    /**
+      Set the amount of memory used to cache raster blocks.  The least
+      recently used blocks are dropped when the limit is reached.  At
+      least one block is always cached.
+
+      \param bytes  Cache size in bytes.
+    */
+    void setCacheSize(std::size_t bytes);
+
     std::vector<pdal::Dimension::Type> getPDALDimensionTypes() const
        { return m_types; }
     /**
@@ -291,9 +327,32 @@ public:
     std::string m_errorMsg;
 
 private:
+    // Values of all bands for the pixels of a raster block, stored by
+    // pixel.
+    struct Block
+    {
+        std::vector<double> m_data;
+        int m_width;
+        std::list<uint64_t>::iterator m_lru;
+    };
+
     bool getPixelAndLinePosition(double x, double y,
         int32_t& pixel, int32_t& line);
     GDALError computePDALDimensionTypes();
+    const double *pixelValues(int pixel, int line);
+    bool isNoData(int band, double value) const;
+    Block *readBlock(int blockX, int blockY, uint64_t key);
+
+    int m_blockXSize;
+    int m_blockYSize;
+    std::vector<double> m_noData;
+    std::vector<uint8_t> m_hasNoData;
+    std::unordered_map<uint64_t, Block> m_blocks;
+    std::list<uint64_t> m_lru;
+    std::size_t m_cacheSize;
+    std::size_t m_cacheUsed;
+    uint64_t m_lastKey;
+    Block *m_lastBlock;
 };
 
 } // namespace gdal
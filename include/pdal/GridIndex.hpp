@@ -0,0 +1,819 @@
+/******************************************************************************
+* Copyright (c) 2016, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <pdal/KDIndex.hpp>
+#include <pdal/PointView.hpp>
+#include <pdal/util/ProgramArgs.hpp>
+#include <pdal/util/ThreadPool.hpp>
+#include <pdal/util/Utils.hpp>
+
+namespace pdal
+{
+
+/**
+  A spatial index that hashes points into a uniform grid of square (2D)
+  or cubic (3D) cells.  The index is built in linear time and is cheaper
+  to query than a KD tree when the points are evenly spread, particularly
+  for radius searches with a radius close to the cell size.  Query results
+  are the same as those of \ref KDIndex, nearest first.
+*/
+template<int DIM>
+class PDAL_DLL GridIndex
+{
+public:
+    /**
+      Create an index of the points of a view.
+
+      \param buf  View holding the points to index.
+      \param cellSize  Length of the side of a grid cell.  Radius searches
+        are fastest when this is the search radius.  Zero picks a size
+        from the mean density of the points.
+    */
+    GridIndex(const PointView& buf, double cellSize = 0) : m_buf(buf),
+        m_cellSize(cellSize)
+    {}
+
+    /**
+      Build the index.
+
+      \param threads  Number of threads used to build the index.  Zero
+        means all hardware threads.
+    */
+    void build(std::size_t threads = 1)
+    {
+        const point_count_t np = m_buf.size();
+        m_cells.clear();
+        m_cellStart.assign(1, 0);
+        m_ids.assign(np, 0);
+        m_coords.assign(np * DIM, 0);
+        if (!np)
+            return;
+
+        ThreadPool pool(threads);
+        const point_count_t numRanges = pool.numThreads() * 4;
+
+        struct Range
+        {
+            PointId begin;
+            PointId end;
+            std::vector<double> coords;
+            double min[DIM];
+            double max[DIM];
+            // Number of points in each cell, which becomes the position
+            // of the range's next point in the cell.
+            std::unordered_map<uint64_t, std::size_t> cells;
+        };
+        std::vector<Range> ranges(numRanges);
+
+        // Fetch the coordinates and bounds of each range of points.
+        for (point_count_t r = 0; r < numRanges; ++r)
+        {
+            Range& range = ranges[r];
+            range.begin = np * r / numRanges;
+            range.end = np * (r + 1) / numRanges;
+            pool.add([this, &range]()
+            {
+                const point_count_t count = range.end - range.begin;
+                range.coords.resize(count * DIM);
+                queryPoints(m_buf, range.begin, range.end,
+                    range.coords.data());
+                for (int d = 0; d < DIM; ++d)
+                {
+                    range.min[d] = (std::numeric_limits<double>::max)();
+                    range.max[d] = (std::numeric_limits<double>::lowest)();
+                }
+                const double *pt = range.coords.data();
+                for (point_count_t i = 0; i < count; ++i, pt += DIM)
+                    for (int d = 0; d < DIM; ++d)
+                    {
+                        range.min[d] = (std::min)(range.min[d], pt[d]);
+                        range.max[d] = (std::max)(range.max[d], pt[d]);
+                    }
+            });
+        }
+        pool.await();
+
+        double max[DIM];
+        for (int d = 0; d < DIM; ++d)
+        {
+            m_min[d] = (std::numeric_limits<double>::max)();
+            max[d] = (std::numeric_limits<double>::lowest)();
+            for (Range& range : ranges)
+            {
+                m_min[d] = (std::min)(m_min[d], range.min[d]);
+                max[d] = (std::max)(max[d], range.max[d]);
+            }
+        }
+        setGrid(max, np);
+
+        // Count the points of each range that fall in each cell.
+        for (Range& range : ranges)
+            pool.add([this, &range]()
+            {
+                const double *pt = range.coords.data();
+                for (PointId i = range.begin; i < range.end; ++i, pt += DIM)
+                    range.cells[key(pt)]++;
+            });
+        pool.await();
+
+        // Number the cells and find where each range's points go.  Points
+        // in a cell are stored in the order of their ids.
+        std::vector<std::size_t> counts;
+        for (Range& range : ranges)
+            for (auto& c : range.cells)
+            {
+                auto res = m_cells.insert(std::make_pair(c.first,
+                    counts.size()));
+                if (res.second)
+                    counts.push_back(0);
+                std::size_t& count = counts[res.first->second];
+                std::size_t rangeCount = c.second;
+                c.second = count;
+                count += rangeCount;
+            }
+        m_cellStart.resize(counts.size() + 1);
+        for (std::size_t c = 0; c < counts.size(); ++c)
+            m_cellStart[c + 1] = m_cellStart[c] + counts[c];
+
+        // Place the points.
+        for (Range& range : ranges)
+            pool.add([this, &range]()
+            {
+                const double *pt = range.coords.data();
+                for (PointId i = range.begin; i < range.end; ++i, pt += DIM)
+                {
+                    uint64_t k = key(pt);
+                    std::size_t pos = m_cellStart[m_cells.find(k)->second] +
+                        range.cells[k]++;
+                    m_ids[pos] = i;
+                    std::copy(pt, pt + DIM, m_coords.data() + pos * DIM);
+                }
+                range = Range();
+            });
+        pool.await();
+    }
+
+    /**
+      Return the length of the side of a grid cell.
+
+      \return  Cell size.
+    */
+    double cellSize() const
+        { return m_cellSize; }
+
+    /**
+      Find the k nearest neighbors of each point of a view.
+
+      \param query  View holding the query points.
+      \param k  Number of neighbors to find for each point.
+      \param threads  Number of threads to use.  Zero means all hardware
+        threads.
+      \return  Table of neighbors of each query point.
+    */
+    NeighborTable knn(const PointView& query, point_count_t k,
+        std::size_t threads = 1) const
+    {
+        NeighborTable table;
+        const point_count_t np = query.size();
+        k = std::min(m_buf.size(), k);
+
+        table.offsets.resize(np + 1);
+        for (PointId i = 0; i <= np; ++i)
+            table.offsets[i] = i * k;
+        table.ids.resize(np * k);
+        table.sqrDists.resize(np * k);
+        if (!k)
+            return table;
+
+        ThreadPool pool(threads);
+        const point_count_t numRanges = pool.numThreads() * 4;
+        for (point_count_t r = 0; r < numRanges; ++r)
+        {
+            PointId begin = np * r / numRanges;
+            PointId end = np * (r + 1) / numRanges;
+            if (begin == end)
+                continue;
+            pool.add([this, &query, &table, k, begin, end]()
+            {
+                std::vector<double> coords((end - begin) * DIM);
+                queryPoints(query, begin, end, coords.data());
+
+                const double *pt = coords.data();
+                for (PointId i = begin; i < end; ++i, pt += DIM)
+                    knnSearch(pt, k, table.ids.data() + i * k,
+                        table.sqrDists.data() + i * k);
+            });
+        }
+        pool.await();
+        return table;
+    }
+
+    /**
+      Find the k nearest neighbors of each point in the index.
+
+      \param k  Number of neighbors to find for each point.  A point is
+        its own nearest neighbor.
+      \param threads  Number of threads to use.  Zero means all hardware
+        threads.
+      \return  Table of neighbors of each point.
+    */
+    NeighborTable knnAll(point_count_t k, std::size_t threads = 1) const
+        { return knn(m_buf, k, threads); }
+
+    /**
+      Find the neighbors within a radius of each point of a view.
+
+      \param query  View holding the query points.
+      \param r  Radius of the neighborhood.
+      \param threads  Number of threads to use.  Zero means all hardware
+        threads.
+      \return  Table of neighbors of each query point.
+    */
+    NeighborTable radius(const PointView& query, double r,
+        std::size_t threads = 1) const
+    {
+        struct RangeResult
+        {
+            std::vector<std::size_t> counts;
+            std::vector<PointId> ids;
+            std::vector<double> sqrDists;
+        };
+
+        NeighborTable table;
+        const point_count_t np = query.size();
+        table.offsets.resize(np + 1);
+
+        ThreadPool pool(threads);
+        const point_count_t numRanges = pool.numThreads() * 4;
+        std::vector<RangeResult> results(numRanges);
+        for (point_count_t rr = 0; rr < numRanges; ++rr)
+        {
+            PointId begin = np * rr / numRanges;
+            PointId end = np * (rr + 1) / numRanges;
+            RangeResult& result = results[rr];
+            pool.add([this, &query, &result, r, begin, end]()
+            {
+                std::vector<double> coords((end - begin) * DIM);
+                queryPoints(query, begin, end, coords.data());
+
+                std::vector<Match> matches;
+                result.counts.resize(end - begin);
+                const double *pt = coords.data();
+                for (PointId i = begin; i < end; ++i, pt += DIM)
+                {
+                    radiusSearch(pt, r, matches);
+                    result.counts[i - begin] = matches.size();
+                    for (const Match& m : matches)
+                    {
+                        result.ids.push_back(m.second);
+                        result.sqrDists.push_back(m.first);
+                    }
+                }
+            });
+        }
+        pool.await();
+
+        PointId i = 0;
+        for (RangeResult& result : results)
+        {
+            for (std::size_t count : result.counts)
+            {
+                table.offsets[i + 1] = table.offsets[i] + count;
+                i++;
+            }
+            table.ids.insert(table.ids.end(), result.ids.begin(),
+                result.ids.end());
+            table.sqrDists.insert(table.sqrDists.end(),
+                result.sqrDists.begin(), result.sqrDists.end());
+            result = RangeResult();
+        }
+        return table;
+    }
+
+    /**
+      Find the neighbors within a radius of each point in the index.
+
+      \param r  Radius of the neighborhood.
+      \param threads  Number of threads to use.  Zero means all hardware
+        threads.
+      \return  Table of neighbors of each point.
+    */
+    NeighborTable radiusAll(double r, std::size_t threads = 1) const
+        { return radius(m_buf, r, threads); }
+
+protected:
+    // Square distance and id of a point.  Ordering by both keeps results
+    // with equal distances in a fixed order.
+    typedef std::pair<double, PointId> Match;
+
+    const PointView& m_buf;
+
+    // Find the k nearest points to 'pt', visiting rings of cells around
+    // the cell holding it until no unvisited cell can hold a point closer
+    // than the k'th nearest found so far.
+    void knnSearch(const double *pt, point_count_t k, PointId *ids,
+        double *sqrDists) const
+    {
+        std::priority_queue<Match> best;
+        if (!k || m_cellStart.size() < 2)
+            return;
+
+        int64_t center[DIM];
+        int64_t first = 0;
+        int64_t last = 0;
+        for (int d = 0; d < DIM; ++d)
+        {
+            center[d] = cell(pt, d);
+            int64_t below = -center[d];
+            int64_t above = center[d] - (m_size[d] - 1);
+            first = (std::max)(first, (std::max)(below, above));
+            last = (std::max)(last,
+                (std::max)(center[d], m_size[d] - 1 - center[d]));
+        }
+
+        auto visit = [pt, k, &best](const double *p, PointId id)
+        {
+            Match m(sqrDist(pt, p), id);
+            if (best.size() < k)
+                best.push(m);
+            else if (m < best.top())
+            {
+                best.pop();
+                best.push(m);
+            }
+        };
+
+        for (int64_t ring = first; ring <= last; ++ring)
+        {
+            // When a ring has more cells than there are occupied cells,
+            // as happens for isolated points, check the remaining
+            // occupied cells directly instead.
+            double ringCells = std::pow(2.0 * ring + 1, DIM) -
+                std::pow(2.0 * ring - 1, DIM);
+            if (ring > 1 && ringCells > m_cells.size())
+            {
+                visitOutside(center, ring, pt, best, k, visit);
+                break;
+            }
+            visitRing(center, ring, visit);
+
+            // Unvisited cells are all outside the block of cells within
+            // 'ring' of the center cell.
+            if (best.size() == k)
+            {
+                double edge = (std::numeric_limits<double>::max)();
+                for (int d = 0; d < DIM; ++d)
+                {
+                    double lo = m_min[d] + (center[d] - ring) * m_cellSize;
+                    double hi = m_min[d] + (center[d] + ring + 1) *
+                        m_cellSize;
+                    edge = (std::min)(edge,
+                        (std::min)(pt[d] - lo, hi - pt[d]));
+                }
+                if (edge >= 0 && best.top().first < edge * edge)
+                    break;
+            }
+        }
+
+        for (std::size_t i = best.size(); i > 0; --i)
+        {
+            ids[i - 1] = best.top().second;
+            sqrDists[i - 1] = best.top().first;
+            best.pop();
+        }
+    }
+
+    // Find the points within 'r' of 'pt', nearest first.
+    void radiusSearch(const double *pt, double r,
+        std::vector<Match>& matches) const
+    {
+        matches.clear();
+        if (m_cellStart.size() < 2)
+            return;
+
+        int64_t lo[DIM];
+        int64_t hi[DIM];
+        for (int d = 0; d < DIM; ++d)
+        {
+            lo[d] = (std::max)(cell(pt[d] - r, d), int64_t(0));
+            hi[d] = (std::min)(cell(pt[d] + r, d), m_size[d] - 1);
+            if (lo[d] > hi[d])
+                return;
+        }
+
+        const double r2 = r * r;
+        visitBox(lo, hi, [pt, r2, &matches](const double *p, PointId id)
+        {
+            double dist = sqrDist(pt, p);
+            if (dist <= r2)
+                matches.push_back(Match(dist, id));
+        });
+        std::sort(matches.begin(), matches.end());
+    }
+
+private:
+    double m_cellSize;
+    double m_min[DIM];
+    int64_t m_size[DIM];
+
+    // Cell number of each occupied grid cell.
+    std::unordered_map<uint64_t, std::size_t> m_cells;
+    // Position in m_ids of the first point of each cell.
+    std::vector<std::size_t> m_cellStart;
+    // Ids and coordinates of the points, grouped by cell.
+    std::vector<PointId> m_ids;
+    std::vector<double> m_coords;
+
+    GridIndex(const GridIndex&);
+    GridIndex& operator=(const GridIndex&);
+
+    static double sqrDist(const double *p1, const double *p2)
+    {
+        double dist = 0;
+        for (int d = 0; d < DIM; ++d)
+            dist += (p1[d] - p2[d]) * (p1[d] - p2[d]);
+        return dist;
+    }
+
+    // Fetch the coordinates of a range of points, interleaved.
+    static void queryPoints(const PointView& view, PointId begin,
+        PointId end, double *coords)
+    {
+        static const Dimension::Id dims[] =
+            { Dimension::Id::X, Dimension::Id::Y, Dimension::Id::Z };
+
+        const point_count_t count = end - begin;
+        std::vector<double> values(count);
+        for (int d = 0; d < DIM; ++d)
+        {
+            view.getFieldsAs(dims[d], begin, end, values.data());
+            for (point_count_t i = 0; i < count; ++i)
+                coords[i * DIM + d] = values[i];
+        }
+    }
+
+    // Set the cell size, if needed, and the number of cells along each
+    // axis.
+    void setGrid(const double *max, point_count_t np)
+    {
+        if (m_cellSize <= 0)
+        {
+            // Aim for a few points in each cell, measuring density over
+            // the axes along which the points are spread.
+            double volume = 1;
+            int dims = 0;
+            for (int d = 0; d < DIM; ++d)
+                if (max[d] > m_min[d])
+                {
+                    volume *= max[d] - m_min[d];
+                    dims++;
+                }
+            m_cellSize = dims ?
+                std::pow(volume * 8 / np, 1.0 / dims) : 1.0;
+        }
+
+        double cells = 1;
+        for (int d = 0; d < DIM; ++d)
+        {
+            m_size[d] = (int64_t)std::floor((max[d] - m_min[d]) /
+                m_cellSize) + 1;
+            cells *= m_size[d];
+        }
+        if (!(cells < std::pow(2.0, 63)))
+            throw pdal_error("GridIndex: cell size is too small for the "
+                "extent of the points.");
+    }
+
+    int64_t cell(double v, int d) const
+        { return (int64_t)std::floor((v - m_min[d]) / m_cellSize); }
+
+    int64_t cell(const double *pt, int d) const
+        { return cell(pt[d], d); }
+
+    uint64_t key(const int64_t *c) const
+    {
+        uint64_t k = 0;
+        for (int d = DIM - 1; d >= 0; --d)
+            k = k * m_size[d] + c[d];
+        return k;
+    }
+
+    uint64_t key(const double *pt) const
+    {
+        int64_t c[DIM];
+        for (int d = 0; d < DIM; ++d)
+            c[d] = (std::min)(cell(pt, d), m_size[d] - 1);
+        return key(c);
+    }
+
+    // Call 'f' for each point in a cell.
+    template<typename F>
+    void visitCell(const int64_t *c, F f) const
+    {
+        auto it = m_cells.find(key(c));
+        if (it == m_cells.end())
+            return;
+        std::size_t begin = m_cellStart[it->second];
+        std::size_t end = m_cellStart[it->second + 1];
+        const double *p = m_coords.data() + begin * DIM;
+        for (std::size_t i = begin; i < end; ++i, p += DIM)
+            f(p, m_ids[i]);
+    }
+
+    // Call 'f' for each point in the cells from 'lo' to 'hi', inclusive.
+    template<typename F>
+    void visitBox(const int64_t *lo, const int64_t *hi, F f) const
+    {
+        int64_t c[DIM];
+        std::copy(lo, lo + DIM, c);
+        while (true)
+        {
+            visitCell(c, f);
+            int d = 0;
+            for (; d < DIM; ++d)
+            {
+                if (++c[d] <= hi[d])
+                    break;
+                c[d] = lo[d];
+            }
+            if (d == DIM)
+                break;
+        }
+    }
+
+    // Call 'f' for each point in the occupied cells whose largest offset
+    // along an axis from 'center' is at least 'ring', skipping cells that
+    // can't hold a point closer to 'pt' than the worst of 'best'.
+    template<typename F>
+    void visitOutside(const int64_t *center, int64_t ring, const double *pt,
+        const std::priority_queue<Match>& best, point_count_t k, F f) const
+    {
+        // Visit the nearest cells first so that more can be skipped.
+        std::vector<std::pair<double, std::size_t>> cells;
+        for (auto& occupied : m_cells)
+        {
+            int64_t c[DIM];
+            uint64_t code = occupied.first;
+            int64_t offset = 0;
+            double dist = 0;
+            for (int d = 0; d < DIM; ++d)
+            {
+                c[d] = code % m_size[d];
+                code /= m_size[d];
+                offset = (std::max)(offset, std::abs(c[d] - center[d]));
+
+                double lo = m_min[d] + c[d] * m_cellSize;
+                double hi = lo + m_cellSize;
+                double delta = (std::max)(0.0,
+                    (std::max)(lo - pt[d], pt[d] - hi));
+                dist += delta * delta;
+            }
+            if (offset >= ring)
+                cells.push_back(std::make_pair(dist, occupied.second));
+        }
+        std::sort(cells.begin(), cells.end());
+
+        for (auto& c : cells)
+        {
+            if (best.size() == k && c.first > best.top().first)
+                break;
+            std::size_t begin = m_cellStart[c.second];
+            std::size_t end = m_cellStart[c.second + 1];
+            const double *p = m_coords.data() + begin * DIM;
+            for (std::size_t i = begin; i < end; ++i, p += DIM)
+                f(p, m_ids[i]);
+        }
+    }
+
+    // Call 'f' for each point in the cells whose largest offset along an
+    // axis from 'center' is 'ring'.
+    template<typename F>
+    void visitRing(const int64_t *center, int64_t ring, F f) const
+    {
+        int64_t lo[DIM];
+        int64_t hi[DIM];
+        for (int d = 0; d < DIM; ++d)
+        {
+            lo[d] = (std::max)(center[d] - ring, int64_t(0));
+            hi[d] = (std::min)(center[d] + ring, m_size[d] - 1);
+            if (lo[d] > hi[d])
+                return;
+        }
+
+        // Step through the cells of the block along all but the last
+        // axis.  Unless one of those is on the ring, only the two ends of
+        // the last axis are on it.
+        const int L = DIM - 1;
+        int64_t c[DIM];
+        std::copy(lo, lo + L, c);
+        while (true)
+        {
+            bool onRing = false;
+            for (int d = 0; d < L; ++d)
+                if (c[d] == center[d] - ring || c[d] == center[d] + ring)
+                    onRing = true;
+            if (onRing)
+            {
+                for (c[L] = lo[L]; c[L] <= hi[L]; ++c[L])
+                    visitCell(c, f);
+            }
+            else
+            {
+                c[L] = center[L] - ring;
+                if (c[L] >= lo[L] && c[L] <= hi[L])
+                    visitCell(c, f);
+                c[L] = center[L] + ring;
+                if (ring && c[L] >= lo[L] && c[L] <= hi[L])
+                    visitCell(c, f);
+            }
+
+            int d = 0;
+            for (; d < L; ++d)
+            {
+                if (++c[d] <= hi[d])
+                    break;
+                c[d] = lo[d];
+            }
+            if (d == L)
+                break;
+        }
+    }
+};
+
+class PDAL_DLL Grid2Index : public GridIndex<2>
+{
+public:
+    using GridIndex<2>::radius;
+
+    Grid2Index(const PointView& buf, double cellSize = 0) :
+        GridIndex<2>(buf, cellSize)
+    {
+        if (!buf.hasDim(Dimension::Id::X))
+            throw pdal_error("Grid2Index: point view missing 'X' dimension.");
+        if (!buf.hasDim(Dimension::Id::Y))
+            throw pdal_error("Grid2Index: point view missing 'Y' dimension.");
+    }
+
+    PointId neighbor(double x, double y) const
+    {
+        std::vector<PointId> ids = neighbors(x, y, 1);
+        return (ids.size() ? ids[0] : 0);
+    }
+
+    std::vector<PointId> neighbors(double x, double y,
+        point_count_t k) const
+    {
+        k = std::min(m_buf.size(), k);
+        std::vector<PointId> output(k);
+        std::vector<double> sqrDists(k);
+
+        double pt[] = { x, y };
+        knnSearch(pt, k, output.data(), sqrDists.data());
+        return output;
+    }
+
+    std::vector<PointId> radius(double x, double y, double r) const
+    {
+        std::vector<PointId> output;
+        std::vector<Match> matches;
+
+        double pt[] = { x, y };
+        radiusSearch(pt, r, matches);
+        for (const Match& m : matches)
+            output.push_back(m.second);
+        return output;
+    }
+};
+
+class PDAL_DLL Grid3Index : public GridIndex<3>
+{
+public:
+    using GridIndex<3>::radius;
+
+    Grid3Index(const PointView& buf, double cellSize = 0) :
+        GridIndex<3>(buf, cellSize)
+    {
+        if (!buf.hasDim(Dimension::Id::X))
+            throw pdal_error("Grid3Index: point view missing 'X' dimension.");
+        if (!buf.hasDim(Dimension::Id::Y))
+            throw pdal_error("Grid3Index: point view missing 'Y' dimension.");
+        if (!buf.hasDim(Dimension::Id::Z))
+            throw pdal_error("Grid3Index: point view missing 'Z' dimension.");
+    }
+
+    PointId neighbor(double x, double y, double z) const
+    {
+        std::vector<PointId> ids = neighbors(x, y, z, 1);
+        return (ids.size() ? ids[0] : 0);
+    }
+
+    std::vector<PointId> neighbors(double x, double y, double z,
+        point_count_t k) const
+    {
+        k = std::min(m_buf.size(), k);
+        std::vector<PointId> output(k);
+        std::vector<double> sqrDists(k);
+
+        double pt[] = { x, y, z };
+        knnSearch(pt, k, output.data(), sqrDists.data());
+        return output;
+    }
+
+    std::vector<PointId> radius(double x, double y, double z,
+        double r) const
+    {
+        std::vector<PointId> output;
+        std::vector<Match> matches;
+
+        double pt[] = { x, y, z };
+        radiusSearch(pt, r, matches);
+        for (const Match& m : matches)
+            output.push_back(m.second);
+        return output;
+    }
+};
+
+/**
+  Spatial indexes that filters can use for neighbor searches.
+*/
+enum class IndexType
+{
+    KDTree,
+    Grid
+};
+
+/**
+  Add the "index" option, which selects the spatial index a filter uses for
+  neighbor searches, to a stage's arguments.  Check the value with
+  \ref parseIndexType.
+
+  \param args  Stage arguments.
+  \param indexType  Variable to receive the option value.
+*/
+inline void addIndexArg(ProgramArgs& args, std::string& indexType)
+{
+    args.add("index", "Spatial index for neighbor searches "
+        "('kdtree' or 'grid')", indexType, "kdtree");
+}
+
+/**
+  Convert the value of an "index" option to an index type.  Throws
+  pdal_error if the value is invalid.
+
+  \param stageName  Name of the stage, used in the error message.
+  \param indexType  Option value.
+  \return  Selected index type.
+*/
+inline IndexType parseIndexType(const std::string& stageName,
+    const std::string& indexType)
+{
+    if (Utils::iequals(indexType, "grid"))
+        return IndexType::Grid;
+    if (Utils::iequals(indexType, "kdtree"))
+        return IndexType::KDTree;
+    throw pdal_error(stageName + ": invalid 'index' option '" +
+        indexType + "'.  Use 'kdtree' or 'grid'.");
+}
+
+} // namespace pdal
@@ -36,8 +36,10 @@
 
 #include "nanoflann.hpp"
 
+#include <deque>
 #include <memory>
 #include <pdal/PointView.hpp>
+#include <pdal/util/ThreadPool.hpp>
 
 namespace nanoflann
 {
@@ -51,6 +53,321 @@ namespace nanoflann
 namespace pdal
 {
 
+/**
+  Neighbors of a set of query points stored in flat arrays (compressed
+  sparse row form).  The neighbors of query point i are at positions
+  offsets[i] through offsets[i + 1] - 1 of ids and sqrDists, nearest first.
+*/
+struct NeighborTable
+{
+    std::vector<std::size_t> offsets;
+    std::vector<PointId> ids;
+    std::vector<double> sqrDists;
+
+    /**
+      Return the number of query points in the table.
+
+      \return  Number of query points.
+    */
+    point_count_t size() const
+        { return offsets.empty() ? 0 : offsets.size() - 1; }
+
+    /**
+      Return the neighbors of a query point.
+
+      \param i  Index of the query point.
+      \return  Ids of the neighbors, nearest first.
+    */
+    ColumnSpan<const PointId> neighbors(PointId i) const
+    {
+        return ColumnSpan<const PointId>(ids.data() + offsets[i],
+            offsets[i + 1] - offsets[i]);
+    }
+
+    /**
+      Return the square distances from a query point to its neighbors.
+
+      \param i  Index of the query point.
+      \return  Square distances, in the order of \ref neighbors.
+    */
+    ColumnSpan<const double> sqrDistances(PointId i) const
+    {
+        return ColumnSpan<const double>(sqrDists.data() + offsets[i],
+            offsets[i + 1] - offsets[i]);
+    }
+};
+
+// A nanoflann tree that can build the subtrees below its top levels on
+// separate threads.  The split rule is nanoflann's, so the tree is the
+// same as one built serially.
+template<typename Distance, class DatasetAdaptor, typename IndexType>
+class KDTree : public nanoflann::KDTreeSingleIndexAdaptor<Distance,
+    DatasetAdaptor, -1, IndexType>
+{
+    typedef nanoflann::KDTreeSingleIndexAdaptor<Distance, DatasetAdaptor,
+        -1, IndexType> Base;
+    typedef typename Base::Node Node;
+    typedef typename Base::NodePtr NodePtr;
+    typedef typename Base::BoundingBox BoundingBox;
+    typedef typename Base::ElementType ElementType;
+    typedef typename Base::DistanceType DistanceType;
+
+public:
+    KDTree(int dimensionality, const DatasetAdaptor& dataset,
+            const nanoflann::KDTreeSingleIndexAdaptorParams& params) :
+        Base(dimensionality, dataset, params)
+    {}
+
+    /**
+      Build the tree.
+
+      \param threads  Number of threads used to build subtrees.  Zero
+        means all hardware threads.
+    */
+    void buildIndex(std::size_t threads)
+    {
+        if (threads == 1)
+        {
+            Base::buildIndex();
+            return;
+        }
+
+        this->m_size = this->dataset.kdtree_get_point_count();
+        this->vind.resize(this->m_size);
+        for (std::size_t i = 0; i < this->m_size; ++i)
+            this->vind[i] = i;
+        this->root_bbox.resize(this->dim);
+        this->dataset.kdtree_get_bbox(this->root_bbox);
+        this->freeIndex();
+        m_pools.clear();
+        if (!this->m_size)
+            return;
+
+        // Split the top levels serially until there are a few subtrees
+        // for each thread, then build the subtrees in parallel.  Nodes
+        // above the subtrees are finished once their subtrees are done.
+        ThreadPool pool(threads);
+        int depth = 0;
+        while ((std::size_t(1) << depth) < pool.numThreads() * 4)
+            depth++;
+
+        std::deque<BoundingBox> boxes;
+        std::vector<std::function<void()>> finish;
+        divideTop(this->root_node, 0, this->m_size, this->root_bbox, depth,
+            pool, boxes, finish);
+        pool.await();
+        for (auto& f : finish)
+            f();
+    }
+
+private:
+    std::vector<std::unique_ptr<nanoflann::PooledAllocator>> m_pools;
+
+    ElementType get(IndexType idx, int dim) const
+        { return this->dataset.kdtree_get_pt(idx, dim); }
+
+    void divideTop(NodePtr& out, IndexType left, IndexType right,
+        BoundingBox& bbox, int depth, ThreadPool& pool,
+        std::deque<BoundingBox>& boxes,
+        std::vector<std::function<void()>>& finish)
+    {
+        if (depth == 0 || (right - left) <= this->m_leaf_max_size)
+        {
+            m_pools.emplace_back(new nanoflann::PooledAllocator);
+            nanoflann::PooledAllocator *alloc = m_pools.back().get();
+            pool.add([this, &out, left, right, &bbox, alloc]()
+                { out = divideTree(*alloc, left, right, bbox); });
+            return;
+        }
+
+        NodePtr node = this->pool.template allocate<Node>();
+        IndexType idx;
+        int cutfeat;
+        DistanceType cutval;
+        middleSplit(&this->vind[0] + left, right - left, idx, cutfeat,
+            cutval, bbox);
+        node->sub.divfeat = cutfeat;
+
+        boxes.push_back(bbox);
+        BoundingBox& leftBox = boxes.back();
+        leftBox[cutfeat].high = cutval;
+        boxes.push_back(bbox);
+        BoundingBox& rightBox = boxes.back();
+        rightBox[cutfeat].low = cutval;
+
+        divideTop(node->child1, left, left + idx, leftBox, depth - 1, pool,
+            boxes, finish);
+        divideTop(node->child2, left + idx, right, rightBox, depth - 1, pool,
+            boxes, finish);
+
+        // Children are pushed before their parents, so running the list
+        // in order finishes the tree from the bottom up.
+        int dim = this->dim;
+        finish.push_back([node, &leftBox, &rightBox, &bbox, cutfeat, dim]()
+        {
+            node->sub.divlow = leftBox[cutfeat].high;
+            node->sub.divhigh = rightBox[cutfeat].low;
+            for (int i = 0; i < dim; ++i)
+            {
+                bbox[i].low = (std::min)(leftBox[i].low, rightBox[i].low);
+                bbox[i].high = (std::max)(leftBox[i].high, rightBox[i].high);
+            }
+        });
+        out = node;
+    }
+
+    NodePtr divideTree(nanoflann::PooledAllocator& alloc, IndexType left,
+        IndexType right, BoundingBox& bbox)
+    {
+        NodePtr node = alloc.allocate<Node>();
+
+        if ((right - left) <= this->m_leaf_max_size)
+        {
+            node->child1 = node->child2 = NULL;
+            node->lr.left = left;
+            node->lr.right = right;
+
+            for (int i = 0; i < this->dim; ++i)
+            {
+                bbox[i].low = get(this->vind[left], i);
+                bbox[i].high = get(this->vind[left], i);
+            }
+            for (IndexType k = left + 1; k < right; ++k)
+                for (int i = 0; i < this->dim; ++i)
+                {
+                    ElementType v = get(this->vind[k], i);
+                    if (bbox[i].low > v)
+                        bbox[i].low = v;
+                    if (bbox[i].high < v)
+                        bbox[i].high = v;
+                }
+        }
+        else
+        {
+            IndexType idx;
+            int cutfeat;
+            DistanceType cutval;
+            middleSplit(&this->vind[0] + left, right - left, idx, cutfeat,
+                cutval, bbox);
+            node->sub.divfeat = cutfeat;
+
+            BoundingBox leftBox(bbox);
+            leftBox[cutfeat].high = cutval;
+            node->child1 = divideTree(alloc, left, left + idx, leftBox);
+
+            BoundingBox rightBox(bbox);
+            rightBox[cutfeat].low = cutval;
+            node->child2 = divideTree(alloc, left + idx, right, rightBox);
+
+            node->sub.divlow = leftBox[cutfeat].high;
+            node->sub.divhigh = rightBox[cutfeat].low;
+            for (int i = 0; i < this->dim; ++i)
+            {
+                bbox[i].low = (std::min)(leftBox[i].low, rightBox[i].low);
+                bbox[i].high = (std::max)(leftBox[i].high, rightBox[i].high);
+            }
+        }
+        return node;
+    }
+
+    void computeMinMax(IndexType *ind, IndexType count, int dim,
+        ElementType& minElem, ElementType& maxElem) const
+    {
+        minElem = maxElem = get(ind[0], dim);
+        for (IndexType i = 1; i < count; ++i)
+        {
+            ElementType v = get(ind[i], dim);
+            if (v < minElem)
+                minElem = v;
+            if (v > maxElem)
+                maxElem = v;
+        }
+    }
+
+    // This matches nanoflann's middleSplit_(), including its use of the
+    // current cut dimension when measuring spread.
+    void middleSplit(IndexType *ind, IndexType count, IndexType& index,
+        int& cutfeat, DistanceType& cutval, const BoundingBox& bbox) const
+    {
+        const DistanceType EPS = static_cast<DistanceType>(0.00001);
+        ElementType maxSpan = bbox[0].high - bbox[0].low;
+        for (int i = 1; i < this->dim; ++i)
+            maxSpan = (std::max)(maxSpan, bbox[i].high - bbox[i].low);
+
+        ElementType maxSpread = -1;
+        cutfeat = 0;
+        for (int i = 0; i < this->dim; ++i)
+        {
+            ElementType span = bbox[i].high - bbox[i].low;
+            if (span > (1 - EPS) * maxSpan)
+            {
+                ElementType minElem, maxElem;
+                computeMinMax(ind, count, cutfeat, minElem, maxElem);
+                ElementType spread = maxElem - minElem;
+                if (spread > maxSpread)
+                {
+                    cutfeat = i;
+                    maxSpread = spread;
+                }
+            }
+        }
+
+        DistanceType splitVal = (bbox[cutfeat].low + bbox[cutfeat].high) / 2;
+        ElementType minElem, maxElem;
+        computeMinMax(ind, count, cutfeat, minElem, maxElem);
+        if (splitVal < minElem)
+            cutval = minElem;
+        else if (splitVal > maxElem)
+            cutval = maxElem;
+        else
+            cutval = splitVal;
+
+        IndexType lim1, lim2;
+        planeSplit(ind, count, cutfeat, cutval, lim1, lim2);
+        if (lim1 > count / 2)
+            index = lim1;
+        else if (lim2 < count / 2)
+            index = lim2;
+        else
+            index = count / 2;
+    }
+
+    void planeSplit(IndexType *ind, IndexType count, int cutfeat,
+        DistanceType cutval, IndexType& lim1, IndexType& lim2) const
+    {
+        IndexType left = 0;
+        IndexType right = count - 1;
+        for (;;)
+        {
+            while (left <= right && get(ind[left], cutfeat) < cutval)
+                ++left;
+            while (right && left <= right &&
+                    get(ind[right], cutfeat) >= cutval)
+                --right;
+            if (left > right || !right)
+                break;
+            std::swap(ind[left], ind[right]);
+            ++left;
+            --right;
+        }
+        lim1 = left;
+        right = count - 1;
+        for (;;)
+        {
+            while (left <= right && get(ind[left], cutfeat) <= cutval)
+                ++left;
+            while (right && left <= right && get(ind[right], cutfeat) > cutval)
+                --right;
+            if (left > right || !right)
+                break;
+            std::swap(ind[left], ind[right]);
+            ++left;
+            --right;
+        }
+        lim2 = left;
+    }
+};
+
 template<int DIM>
 class PDAL_DLL KDIndex
 {
@@ -69,18 +386,235 @@ public:
     double kdtree_distance(const double *p1, const PointId p2_idx,
         size_t /*numDims*/) const;
     template <class BBOX> bool kdtree_get_bbox(BBOX& bb) const;
-    void build()
+    /**
+      Build the index.
+
+      \param threads  Number of threads used to build the tree.  Zero
+        means all hardware threads.
+      \param cache  Copy the coordinates of the points into a packed array
+        first, so that building and querying the tree read contiguous
+        memory instead of fetching each coordinate from the point view.
+        Uses DIM doubles of memory per point.  Later changes to the
+        coordinates in the view aren't seen by the index.
+    */
+    void build(std::size_t threads = 1, bool cache = false)
     {
+        m_coords.clear();
+        if (cache)
+        {
+            // Fill a separate array so that queryPoints() reads the view.
+            const point_count_t np = m_buf.size();
+            std::vector<double> coords(np * DIM);
+
+            ThreadPool pool(threads);
+            const point_count_t numRanges = pool.numThreads() * 4;
+            for (point_count_t r = 0; r < numRanges; ++r)
+            {
+                PointId begin = np * r / numRanges;
+                PointId end = np * (r + 1) / numRanges;
+                if (begin < end)
+                    pool.add([this, begin, end, &coords]()
+                    {
+                        queryPoints(m_buf, begin, end,
+                            coords.data() + begin * DIM);
+                    });
+            }
+            pool.await();
+            m_coords.swap(coords);
+        }
+
         m_index.reset(new my_kd_tree_t(DIM, *this,
             nanoflann::KDTreeSingleIndexAdaptorParams(10, DIM)));
-        m_index->buildIndex();
+        m_index->buildIndex(threads);
+    }
+
+    /**
+      Find the k nearest neighbors of each point of a view.  Queries are
+      split into ranges that run on a pool of threads, writing straight
+      into the result table.
+
+      \param query  View holding the query points.
+      \param k  Number of neighbors to find for each point.
+      \param threads  Number of threads to use.  Zero means all hardware
+        threads.
+      \return  Table of neighbors of each query point.
+    */
+    NeighborTable knn(const PointView& query, point_count_t k,
+        std::size_t threads = 1) const
+    {
+        NeighborTable table;
+        const point_count_t np = query.size();
+        k = std::min(m_buf.size(), k);
+
+        table.offsets.resize(np + 1);
+        for (PointId i = 0; i <= np; ++i)
+            table.offsets[i] = i * k;
+        table.ids.resize(np * k);
+        table.sqrDists.resize(np * k);
+        if (!k)
+            return table;
+
+        ThreadPool pool(threads);
+        const point_count_t numRanges = pool.numThreads() * 4;
+        for (point_count_t r = 0; r < numRanges; ++r)
+        {
+            PointId begin = np * r / numRanges;
+            PointId end = np * (r + 1) / numRanges;
+            if (begin == end)
+                continue;
+            pool.add([this, &query, &table, k, begin, end]()
+            {
+                std::vector<double> coords((end - begin) * DIM);
+                queryPoints(query, begin, end, coords.data());
+
+                const double *pt = coords.data();
+                for (PointId i = begin; i < end; ++i, pt += DIM)
+                {
+                    nanoflann::KNNResultSet<double, PointId, point_count_t>
+                        resultSet(k);
+                    resultSet.init(table.ids.data() + i * k,
+                        table.sqrDists.data() + i * k);
+                    m_index->findNeighbors(resultSet, pt,
+                        nanoflann::SearchParams(10));
+                }
+            });
+        }
+        pool.await();
+        return table;
+    }
+
+    /**
+      Find the k nearest neighbors of each point in the index.
+
+      \param k  Number of neighbors to find for each point.  A point is
+        its own nearest neighbor.
+      \param threads  Number of threads to use.  Zero means all hardware
+        threads.
+      \return  Table of neighbors of each point.
+    */
+    NeighborTable knnAll(point_count_t k, std::size_t threads = 1) const
+        { return knn(m_buf, k, threads); }
+
+    /**
+      Find the neighbors within a radius of each point of a view.  Each
+      range of queries collects its results in its own buffers, which are
+      joined into the table once all queries are done.
+
+      \param query  View holding the query points.
+      \param r  Radius of the neighborhood.
+      \param threads  Number of threads to use.  Zero means all hardware
+        threads.
+      \return  Table of neighbors of each query point.
+    */
+    NeighborTable radius(const PointView& query, double r,
+        std::size_t threads = 1) const
+    {
+        struct RangeResult
+        {
+            std::vector<std::size_t> counts;
+            std::vector<PointId> ids;
+            std::vector<double> sqrDists;
+        };
+
+        NeighborTable table;
+        const point_count_t np = query.size();
+        table.offsets.resize(np + 1);
+
+        ThreadPool pool(threads);
+        const point_count_t numRanges = pool.numThreads() * 4;
+        std::vector<RangeResult> results(numRanges);
+        for (point_count_t rr = 0; rr < numRanges; ++rr)
+        {
+            PointId begin = np * rr / numRanges;
+            PointId end = np * (rr + 1) / numRanges;
+            RangeResult& result = results[rr];
+            pool.add([this, &query, &result, r, begin, end]()
+            {
+                std::vector<double> coords((end - begin) * DIM);
+                queryPoints(query, begin, end, coords.data());
+
+                nanoflann::SearchParams params;
+                params.sorted = true;
+                std::vector<std::pair<std::size_t, double>> matches;
+                result.counts.resize(end - begin);
+
+                // Our distance metric is square distance, so we use the
+                // square of the radius.
+                const double *pt = coords.data();
+                for (PointId i = begin; i < end; ++i, pt += DIM)
+                {
+                    std::size_t count =
+                        m_index->radiusSearch(pt, r * r, matches, params);
+                    result.counts[i - begin] = count;
+                    for (std::size_t j = 0; j < count; ++j)
+                    {
+                        result.ids.push_back(matches[j].first);
+                        result.sqrDists.push_back(matches[j].second);
+                    }
+                }
+            });
+        }
+        pool.await();
+
+        PointId i = 0;
+        for (RangeResult& result : results)
+        {
+            for (std::size_t count : result.counts)
+            {
+                table.offsets[i + 1] = table.offsets[i] + count;
+                i++;
+            }
+            table.ids.insert(table.ids.end(), result.ids.begin(),
+                result.ids.end());
+            table.sqrDists.insert(table.sqrDists.end(),
+                result.sqrDists.begin(), result.sqrDists.end());
+            result = RangeResult();
+        }
+        return table;
     }
 
+    /**
+      Find the neighbors within a radius of each point in the index.
+
+      \param r  Radius of the neighborhood.
+      \param threads  Number of threads to use.  Zero means all hardware
+        threads.
+      \return  Table of neighbors of each point.
+    */
+    NeighborTable radiusAll(double r, std::size_t threads = 1) const
+        { return radius(m_buf, r, threads); }
+
 protected:
     const PointView& m_buf;
 
-    typedef nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Simple_Adaptor<
-        double, KDIndex, double>, KDIndex, -1, std::size_t> my_kd_tree_t;
+    std::vector<double> m_coords;
+
+    // Fetch the coordinates of a range of query points, interleaved.
+    void queryPoints(const PointView& query, PointId begin, PointId end,
+        double *coords) const
+    {
+        static const Dimension::Id dims[] =
+            { Dimension::Id::X, Dimension::Id::Y, Dimension::Id::Z };
+
+        const point_count_t count = end - begin;
+        if (&query == &m_buf && m_coords.size())
+        {
+            std::copy(m_coords.begin() + begin * DIM,
+                m_coords.begin() + end * DIM, coords);
+            return;
+        }
+
+        std::vector<double> values(count);
+        for (int d = 0; d < DIM; ++d)
+        {
+            query.getFieldsAs(dims[d], begin, end, values.data());
+            for (point_count_t i = 0; i < count; ++i)
+                coords[i * DIM + d] = values[i];
+        }
+    }
+
+    typedef KDTree<nanoflann::L2_Simple_Adaptor<double, KDIndex, double>,
+        KDIndex, std::size_t> my_kd_tree_t;
 
     std::unique_ptr<my_kd_tree_t> m_index;
 
@@ -92,6 +626,8 @@ private:
 class PDAL_DLL KD2Index : public KDIndex<2>
 {
 public:
+    using KDIndex<2>::radius;
+
     KD2Index(const PointView& buf) : KDIndex<2>(buf)
     {
         if (!buf.hasDim(Dimension::Id::X))
@@ -115,10 +651,8 @@ public:
 
         resultSet.init(&output[0], &out_dist_sqr[0]);
 
-        std::vector<double> pt;
-        pt.push_back(x);
-        pt.push_back(y);
-        m_index->findNeighbors(resultSet, &pt[0], nanoflann::SearchParams(10));
+        double pt[] = { x, y };
+        m_index->findNeighbors(resultSet, pt, nanoflann::SearchParams(10));
         return output;
     }
 
@@ -130,14 +664,12 @@ public:
         nanoflann::SearchParams params;
         params.sorted = true;
 
-        std::vector<double> pt;
-        pt.push_back(x);
-        pt.push_back(y);
+        double pt[] = { x, y };
 
         // Our distance metric is square distance, so we use the square of
         // the radius.
         const std::size_t count =
-            m_index->radiusSearch(&pt[0], r * r, ret_matches, params);
+            m_index->radiusSearch(pt, r * r, ret_matches, params);
 
         for (std::size_t i = 0; i < count; ++i)
             output.push_back(ret_matches[i].first);
@@ -148,6 +680,8 @@ public:
 class PDAL_DLL KD3Index : public KDIndex<3>
 {
 public:
+    using KDIndex<3>::radius;
+
     KD3Index(const PointView& buf) : KDIndex<3>(buf)
     {
         if (!buf.hasDim(Dimension::Id::X))
@@ -174,11 +708,8 @@ public:
 
         resultSet.init(&output[0], &out_dist_sqr[0]);
 
-        std::vector<double> pt;
-        pt.push_back(x);
-        pt.push_back(y);
-        pt.push_back(z);
-        m_index->findNeighbors(resultSet, &pt[0], nanoflann::SearchParams(10));
+        double pt[] = { x, y, z };
+        m_index->findNeighbors(resultSet, pt, nanoflann::SearchParams(10));
         return output;
     }
     
@@ -190,11 +721,8 @@ public:
         
         resultSet.init(&indices->front(), &sqr_dists->front());
         
-        std::vector<double> pt;
-        pt.push_back(x);
-        pt.push_back(y);
-        pt.push_back(z);
-        m_index->findNeighbors(resultSet, &pt[0], nanoflann::SearchParams(10));
+        double pt[] = { x, y, z };
+        m_index->findNeighbors(resultSet, pt, nanoflann::SearchParams(10));
     }
 
     std::vector<PointId> radius(double x, double y, double z, double r) const
@@ -204,15 +732,12 @@ public:
         nanoflann::SearchParams params;
         params.sorted = true;
 
-        std::vector<double> pt;
-        pt.push_back(x);
-        pt.push_back(y);
-        pt.push_back(z);
+        double pt[] = { x, y, z };
 
         // Our distance metric is square distance, so we use the square of
         // the radius.
         const std::size_t count =
-            m_index->radiusSearch(&pt[0], r * r, ret_matches, params);
+            m_index->radiusSearch(pt, r * r, ret_matches, params);
 
         for (std::size_t i = 0; i < count; ++i)
             output.push_back(ret_matches[i].first);
@@ -226,6 +751,8 @@ double KDIndex<2>::kdtree_get_pt(const PointId idx, int dim) const
 {
     if (idx >= m_buf.size())
         return 0.0;
+    if (m_coords.size())
+        return m_coords[idx * 2 + dim];
 
     Dimension::Id id = Dimension::Id::Unknown;
     switch (dim)
@@ -249,6 +776,8 @@ double KDIndex<3>::kdtree_get_pt(const PointId idx, int dim) const
 {
     if (idx >= m_buf.size())
         return 0.0;
+    if (m_coords.size())
+        return m_coords[idx * 3 + dim];
 
     Dimension::Id id = Dimension::Id::Unknown;
     switch (dim)
@@ -275,6 +804,14 @@ template<>
 inline double KDIndex<2>::kdtree_distance(const double *p1, const PointId idx,
     size_t /*numDims*/) const
 {
+    if (m_coords.size())
+    {
+        const double *p2 = m_coords.data() + idx * 2;
+        double d0 = p1[0] - p2[0];
+        double d1 = p1[1] - p2[1];
+        return (d0 * d0 + d1 * d1);
+    }
+
     double d0 = p1[0] - m_buf.getFieldAs<double>(Dimension::Id::X, idx);
     double d1 = p1[1] - m_buf.getFieldAs<double>(Dimension::Id::Y, idx);
 
@@ -285,6 +822,15 @@ template<>
 inline double KDIndex<3>::kdtree_distance(const double *p1, const PointId idx,
     size_t /*numDims*/) const
 {
+    if (m_coords.size())
+    {
+        const double *p2 = m_coords.data() + idx * 3;
+        double d0 = p1[0] - p2[0];
+        double d1 = p1[1] - p2[1];
+        double d2 = p1[2] - p2[2];
+        return (d0 * d0 + d1 * d1 + d2 * d2);
+    }
+
     double d0 = p1[0] - m_buf.getFieldAs<double>(Dimension::Id::X, idx);
     double d1 = p1[1] - m_buf.getFieldAs<double>(Dimension::Id::Y, idx);
     double d2 = p1[2] - m_buf.getFieldAs<double>(Dimension::Id::Z, idx);
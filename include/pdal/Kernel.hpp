@@ -92,6 +92,9 @@ protected:
         std::string driver);
     Stage& makeWriter(const std::string& outputFile, Stage& parent,
         std::string driver, Options options);
+    // Number of threads stages may use, from the "threads" switch.
+    std::size_t threads() const
+        { return m_threads; }
 
 public:
     virtual void addSwitches(ProgramArgs& args)
@@ -133,6 +136,7 @@ private:
     std::string m_offsets;
     bool m_visualize;
     std::string m_label;
+    std::size_t m_threads;
 
     Kernel& operator=(const Kernel&); // not implemented
     Kernel(const Kernel&); // not implemented
@@ -123,6 +123,12 @@ public:
     /// pdal::Log::get is less than the logging level of the pdal::Log instance
     std::ostream& get(LogLevel level = LogLevel::Info);
 
+    /// Send log output written by the calling thread to \a out, or back to
+    /// the log's own stream if \a out is null.  Used to keep the messages of
+    /// stages running on a thread pool from interleaving.
+    /// \param out  Stream to receive the calling thread's log output.
+    static void redirectThread(std::ostream *out);
+
     /// Sets the floating point precision
     void floatPrecision(int level);
 
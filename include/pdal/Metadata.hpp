@@ -42,6 +42,7 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <stdint.h>
 
@@ -75,6 +76,10 @@ private:
     MetadataNodeImpl() : m_kind(MetadataType::Instance)
     {}
 
+    // Stages may add metadata while running views on several threads.
+    // Insertion is rare, so a single lock is shared by all nodes.
+    static std::mutex& mutex();
+
     void makeArray(MetadataImplList& l)
     {
         for (auto li = l.begin(); li != l.end(); ++li)
@@ -86,6 +91,7 @@ private:
 
     MetadataNodeImplPtr add(const std::string& name)
     {
+        std::lock_guard<std::mutex> lock(mutex());
         MetadataNodeImplPtr sub(new MetadataNodeImpl(name));
         MetadataImplList& l = m_subnodes[name];
         l.push_back(sub);
@@ -96,6 +102,7 @@ private:
 
     MetadataNodeImplPtr addList(const std::string& name)
     {
+        std::lock_guard<std::mutex> lock(mutex());
         MetadataNodeImplPtr sub(new MetadataNodeImpl(name));
         MetadataImplList& l = m_subnodes[name];
         l.push_back(sub);
@@ -105,6 +112,7 @@ private:
 
     MetadataNodeImplPtr add(MetadataNodeImplPtr node)
     {
+        std::lock_guard<std::mutex> lock(mutex());
         MetadataImplList& l = m_subnodes[node->m_name];
         l.push_back(node);
         if (l.size() > 1)
@@ -114,6 +122,7 @@ private:
 
     MetadataNodeImplPtr addList(MetadataNodeImplPtr node)
     {
+        std::lock_guard<std::mutex> lock(mutex());
         MetadataImplList& l = m_subnodes[node->m_name];
         l.push_back(node);
         makeArray(l);
@@ -106,6 +106,7 @@ public:
     QuickInfo preview() const;
     void prepare() const;
     point_count_t execute();
+    void execute(StreamPointTable& table);
     void validateStageOptions() const;
 
     // Get the resulting point views.
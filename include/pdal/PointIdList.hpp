@@ -0,0 +1,148 @@
+/******************************************************************************
+* Copyright (c) 2016, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <deque>
+
+#include <pdal/pdal_types.hpp>
+
+namespace pdal
+{
+
+// List of the table IDs of the points in a PointView.  As long as the IDs
+// form a single contiguous range, which is the case for a view built by a
+// reader or for an unordered subset of adjacent points, only the range is
+// stored.  IDs are stored explicitly once the list is reordered or an ID
+// that doesn't extend the range is added.
+class PointIdList
+{
+public:
+    PointIdList() : m_first(0), m_size(0), m_explicit(false)
+    {}
+
+    point_count_t size() const
+        { return m_size; }
+    bool empty() const
+        { return m_size == 0; }
+
+    PointId operator[](PointId idx) const
+        { return m_explicit ? m_ids[idx] : m_first + idx; }
+
+    // Set the ID stored at a position.
+    void set(PointId idx, PointId id)
+    {
+        if (!m_explicit)
+        {
+            if (id == m_first + idx)
+                return;
+            materialize();
+        }
+        m_ids[idx] = id;
+    }
+
+    void push_back(PointId id)
+    {
+        if (!m_explicit)
+        {
+            if (m_size == 0)
+                m_first = id;
+            if (id == m_first + m_size)
+            {
+                m_size++;
+                return;
+            }
+            materialize();
+        }
+        m_ids.push_back(id);
+        m_size++;
+    }
+
+    // Append the first 'count' IDs of another list.
+    void append(const PointIdList& other, point_count_t count)
+    {
+        if (!m_explicit && !other.m_explicit &&
+            (m_size == 0 || other.m_first == m_first + m_size))
+        {
+            if (m_size == 0)
+                m_first = other.m_first;
+            m_size += count;
+            return;
+        }
+        for (PointId i = 0; i < count; ++i)
+            push_back(other[i]);
+    }
+
+    // Drop all IDs past the first 'count'.
+    void truncate(point_count_t count)
+    {
+        if (count >= m_size)
+            return;
+        if (m_explicit)
+            m_ids.resize(count);
+        m_size = count;
+    }
+
+    // Return the number of IDs, starting at position 'idx' and up to
+    // 'limit', that are consecutive.
+    point_count_t runLength(PointId idx, point_count_t limit) const
+    {
+        if (!m_explicit)
+            return limit;
+        point_count_t count = 1;
+        PointId id = m_ids[idx];
+        while (count < limit && m_ids[idx + count] == id + count)
+            count++;
+        return count;
+    }
+
+    // Whether the IDs are stored explicitly.
+    bool isExplicit() const
+        { return m_explicit; }
+
+private:
+    void materialize()
+    {
+        for (PointId i = 0; i < m_size; ++i)
+            m_ids.push_back(m_first + i);
+        m_explicit = true;
+    }
+
+    PointId m_first;
+    point_count_t m_size;
+    bool m_explicit;
+    std::deque<PointId> m_ids;
+};
+
+} // namespace pdal
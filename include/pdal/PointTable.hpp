@@ -34,7 +34,11 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <set>
+#include <type_traits>
 #include <vector>
 
 #include "pdal/SpatialReference.hpp"
@@ -101,6 +105,16 @@ private:
 protected:
     virtual char *getPoint(PointId idx) = 0;
 
+    /// Get a pointer to the value of a dimension for a point and the
+    /// number of points, starting with this one, whose values can be
+    /// reached by stepping \a stride bytes.  Tables that don't allow
+    /// direct access return NULL and their fields are accessed point by
+    /// point.
+    virtual char *getFieldRun(const Dimension::Detail * /*d*/,
+            PointId /*idx*/, point_count_t& /*count*/,
+            std::size_t& /*stride*/)
+        { return nullptr; }
+
 protected:
     MetadataPtr m_metadata;
     std::set<SpatialReference> m_spatialRefs;
@@ -142,13 +156,21 @@ private:
 class PDAL_DLL PointTable : public SimplePointTable
 {
 private:
-    // Point storage.
-    std::vector<char *> m_blocks;
+    // Point storage.  Points may be added from several threads at once
+    // when views are run in parallel.  The array of block pointers is
+    // never reallocated in place: when it fills, a larger copy is made and
+    // published through m_blocks, so getPoint() doesn't need to lock.
+    std::atomic<char **> m_blocks;
+    std::vector<std::unique_ptr<char *[]>> m_blockArrays;
+    std::size_t m_numBlocks;
+    std::size_t m_blockCapacity;
     point_count_t m_numPts;
+    std::mutex m_mutex;
     static const point_count_t m_blockPtCnt = 65536;
 
 public:
-    PointTable() : SimplePointTable(m_layout), m_numPts(0)
+    PointTable() : SimplePointTable(m_layout), m_blocks(nullptr),
+        m_numBlocks(0), m_blockCapacity(0), m_numPts(0)
         {}
     virtual ~PointTable();
     virtual bool supportsView() const
@@ -156,6 +178,8 @@ public:
 
 protected:
     virtual char *getPoint(PointId idx);
+    virtual char *getFieldRun(const Dimension::Detail *d, PointId idx,
+        point_count_t& count, std::size_t& stride);
 
 private:
     // Point data operations.
@@ -164,6 +188,92 @@ private:
     PointLayout m_layout;
 };
 
+/// A contiguous run of the values of one dimension.
+template<typename T>
+class ColumnSpan
+{
+public:
+    ColumnSpan(T *data, point_count_t size) : m_data(data), m_size(size)
+    {}
+
+    T *data() const
+        { return m_data; }
+    T *begin() const
+        { return m_data; }
+    T *end() const
+        { return m_data + m_size; }
+    point_count_t size() const
+        { return m_size; }
+    T& operator[](point_count_t i) const
+        { return m_data[i]; }
+
+private:
+    T *m_data;
+    point_count_t m_size;
+};
+
+// Point table that stores the values of each dimension contiguously
+// (structure of arrays) rather than point by point.  Points are stored in
+// blocks like PointTable.  Within a block the values of a dimension start
+// at the dimension's offset times the number of points in the block.
+class PDAL_DLL ColumnPointTable : public BasePointTable
+{
+private:
+    std::atomic<char **> m_blocks;
+    std::vector<std::unique_ptr<char *[]>> m_blockArrays;
+    std::size_t m_numBlocks;
+    std::size_t m_blockCapacity;
+    point_count_t m_numPts;
+    std::mutex m_mutex;
+    static const point_count_t m_blockPtCnt = 65536;
+
+public:
+    ColumnPointTable() : BasePointTable(m_layout), m_blocks(nullptr),
+        m_numBlocks(0), m_blockCapacity(0), m_numPts(0)
+        {}
+    virtual ~ColumnPointTable();
+    virtual bool supportsView() const
+        { return true; }
+
+    /// Determine whether a dimension is stored as type T.
+    /// \param dim  Dimension to check.
+    /// \return  Whether the dimension's values can be accessed as T.
+    template<typename T>
+    bool columnIs(Dimension::Id dim) const
+    {
+        typedef Dimension::BaseType BaseType;
+
+        const Dimension::Detail *d = m_layoutRef.dimDetail(dim);
+        BaseType b = std::is_floating_point<T>::value ? BaseType::Floating :
+            std::is_signed<T>::value ? BaseType::Signed : BaseType::Unsigned;
+        return Dimension::base(d->type()) == b && d->size() == sizeof(T);
+    }
+
+    /// Get a pointer to the value of a dimension for a point and the
+    /// number of points whose values follow it contiguously.
+    /// \param d  Detail of the dimension.
+    /// \param idx  Point ID.
+    /// \param[out] count  Number of contiguous values starting at \a idx.
+    /// \return  Pointer to the value of the dimension for point \a idx.
+    char *getColumn(const Dimension::Detail *d, PointId idx,
+        point_count_t& count);
+
+protected:
+    virtual char *getPoint(PointId idx);
+    virtual char *getFieldRun(const Dimension::Detail *d, PointId idx,
+        point_count_t& count, std::size_t& stride);
+
+private:
+    virtual PointId addPoint();
+    virtual void setFieldInternal(Dimension::Id id, PointId idx,
+        const void *value);
+    virtual void getFieldInternal(Dimension::Id id, PointId idx,
+        void *value) const;
+    char *getDimension(const Dimension::Detail *d, PointId idx) const;
+
+    PointLayout m_layout;
+};
+
 /// A StreamPointTable must provide storage for point data up to its capacity.
 /// It must implement getPoint() which returns a pointer to a buffer of
 /// sufficient size to contain a point's data.  The minimum size required
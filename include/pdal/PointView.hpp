@@ -37,16 +37,19 @@
 #include <pdal/DimDetail.hpp>
 #include <pdal/DimType.hpp>
 #include <pdal/PointContainer.hpp>
+#include <pdal/PointIdList.hpp>
 #include <pdal/PointLayout.hpp>
 #include <pdal/PointRef.hpp>
 #include <pdal/PointTable.hpp>
 #include <pdal/util/Bounds.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <memory>
 #include <queue>
 #include <set>
 #include <vector>
-#include <deque>
 
 #ifdef PDAL_COMPILER_MSVC
 #  pragma warning(disable: 4244)  // conversion from 'type1' to 'type2', possible loss of data
@@ -62,6 +65,8 @@ namespace plang
 struct PointViewLess;
 class PointView;
 class PointViewIter;
+class KD2Index;
+class KD3Index;
 
 typedef std::shared_ptr<PointView> PointViewPtr;
 typedef std::set<PointViewPtr, PointViewLess> PointViewSet;
@@ -75,8 +80,7 @@ public:
 	PointView(PointTableRef pointTable);
 	PointView(PointTableRef pointTable, const SpatialReference& srs);
 
-    virtual ~PointView()
-    {}
+    virtual ~PointView();
 
     PointViewIter begin();
     PointViewIter end();
@@ -93,13 +97,13 @@ public:
     inline void appendPoint(const PointView& buffer, PointId id);
     void append(const PointView& buf)
     {
-        // We use size() instead of the index end because temp points
-        // might have been placed at the end of the buffer.
-        auto thisEnd = m_index.begin() + size();
-        auto bufEnd = buf.m_index.begin() + buf.size();
-        m_index.insert(thisEnd, buf.m_index.begin(), bufEnd);
+        // Temp points might have been placed at the end of the index.
+        // They're cleared anyway, so drop them before appending.
+        m_index.truncate(size());
+        m_index.append(buf.m_index, buf.size());
         m_size += buf.size();
         clearTemps();
+        clearSpatialIndex();
     }
 
     /// Return a new point view with the same point table as this
@@ -112,6 +116,16 @@ public:
     PointRef point(PointId id)
         { return PointRef(*this, id); }
 
+    /// Get a reference to a point that reads and writes the point table
+    /// directly.  Unlike point(), writing X, Y or Z through the reference
+    /// doesn't discard the view's spatial index, so several threads can
+    /// write distinct, existing points at once.  Call clearSpatialIndex()
+    /// first if coordinates will change.
+    /// \param id  ID of an existing point in the view.
+    /// \return  Reference to the point in the view's table.
+    PointRef tablePoint(PointId id)
+        { return PointRef(m_pointTable, m_index[id]); }
+
     template<class T>
     T getFieldAs(Dimension::Id dim, PointId pointIndex) const;
 
@@ -121,6 +135,27 @@ public:
     template<typename T>
     void setField(Dimension::Id dim, PointId idx, T val);
 
+    /// Get the values of a dimension for a range of points, converted to
+    /// type T.  Points that are adjacent in the point table are read in a
+    /// single pass without per-point type dispatch.
+    /// \param[in] dim    Dimension to fetch.
+    /// \param[in] begin  Index of the first point.
+    /// \param[in] end    Index one past the last point.
+    /// \param[out] out   Buffer to fill with (end - begin) values.
+    template<typename T>
+    void getFieldsAs(Dimension::Id dim, PointId begin, PointId end,
+        T *out) const;
+
+    /// Set the values of a dimension for a range of existing points from
+    /// values of type T.
+    /// \param[in] dim    Dimension to set.
+    /// \param[in] begin  Index of the first point.
+    /// \param[in] end    Index one past the last point.
+    /// \param[in] in     Buffer holding (end - begin) values.
+    template<typename T>
+    void setFields(Dimension::Id dim, PointId begin, PointId end,
+        const T *in);
+
     inline void setField(Dimension::Id dim, Dimension::Type type,
         PointId idx, const void *val);
 
@@ -215,6 +250,38 @@ public:
     SpatialReference spatialReference() const
         { return m_spatialReference; }
 
+    /// Determine whether the values of a dimension can be accessed as
+    /// columns of type T (see column()).
+    /// \param[in] dim  Dimension to check.
+    /// \return  Whether column<T>(dim) can be called.
+    template<typename T>
+    bool hasColumn(Dimension::Id dim) const
+    {
+        const ColumnPointTable *t =
+            dynamic_cast<const ColumnPointTable *>(&m_pointTable);
+        return t && t->columnIs<T>(dim);
+    }
+
+    /// Get the values of a dimension for the points in the view as a list
+    /// of contiguous runs.  Points of the view that are adjacent in a
+    /// ColumnPointTable block make up a single run, so a view that hasn't
+    /// been reordered has one run per block.  Throws pdal_error if the
+    /// view's table isn't a ColumnPointTable or the dimension isn't stored
+    /// as type T.  Since the values may be written through the runs, getting
+    /// X, Y or Z discards the spatial indexes that depend on it.
+    /// \param[in] dim  Dimension whose values should be returned.
+    /// \return  Runs of values, in the order of the points in the view.
+    template<typename T>
+    std::vector<ColumnSpan<T>> column(Dimension::Id dim)
+    {
+        coordsChanged(dim);
+        return columnSpans<T>(dim);
+    }
+
+    template<typename T>
+    std::vector<ColumnSpan<const T>> column(Dimension::Id dim) const
+        { return columnSpans<const T>(dim); }
+
     /// Fill a buffer with point data specified by the dimension list.
     /// \param[in] dims  List of dimensions/types to retrieve.
     /// \param[in] idx   Index of point to get.
@@ -258,9 +325,36 @@ public:
     }
     MetadataNode toMetadata() const;
 
+    /// Get a 2D KD index of the points in the view, building it the first
+    /// time it's requested.  The index is kept with the view so that later
+    /// stages can use it without building it again.  It's discarded when X
+    /// or Y is set through the view or when points are added to the view
+    /// or reordered.
+    /// \param threads  Number of threads used to build the index.  Zero
+    ///   means all hardware threads.
+    /// \return  Index of the points in the view.
+    KD2Index& build2dIndex(std::size_t threads = 1);
+
+    /// Get a 3D KD index of the points in the view, building it the first
+    /// time it's requested.  The index is discarded when X, Y or Z is set
+    /// through the view or when points are added to the view or reordered.
+    /// \param threads  Number of threads used to build the index.  Zero
+    ///   means all hardware threads.
+    /// \return  Index of the points in the view.
+    KD3Index& build3dIndex(std::size_t threads = 1);
+
+    /// Discard any spatial index kept with the view.  Changes made through
+    /// getPoint() or through another view of the same points aren't seen,
+    /// so call this after making them.
+    void clearSpatialIndex()
+    {
+        m_spatialIndex.kd2.reset();
+        m_spatialIndex.kd3.reset();
+    }
+
 protected:
     PointTableRef m_pointTable;
-    std::deque<PointId> m_index;
+    PointIdList m_index;
     // The index might be larger than the size to support temporary point
     // references.
     point_count_t m_size;
@@ -269,7 +363,37 @@ protected:
     SpatialReference m_spatialReference;
 
 private:
-    static int m_lastId;
+    // Indexes are built over a particular view, so they aren't copied
+    // along with it.
+    struct SpatialIndex
+    {
+        SpatialIndex()
+        {}
+        SpatialIndex(const SpatialIndex&)
+        {}
+        SpatialIndex& operator=(const SpatialIndex&)
+        {
+            kd2.reset();
+            kd3.reset();
+            return *this;
+        }
+
+        std::shared_ptr<KD2Index> kd2;
+        std::shared_ptr<KD3Index> kd3;
+    };
+
+    static std::atomic<int> m_lastId;
+    SpatialIndex m_spatialIndex;
+
+    void coordsChanged(Dimension::Id dim)
+    {
+        using namespace Dimension;
+
+        if (dim == Id::X || dim == Id::Y)
+            clearSpatialIndex();
+        else if (dim == Id::Z)
+            m_spatialIndex.kd3.reset();
+    }
 
     template<typename T_IN, typename T_OUT>
     bool convertAndSet(Dimension::Id dim, PointId idx, T_IN in);
@@ -282,6 +406,16 @@ private:
 
     template<class T>
     T getFieldInternal(Dimension::Id dim, PointId pointIndex) const;
+    template<typename T>
+    std::vector<ColumnSpan<T>> columnSpans(Dimension::Id dim) const;
+    inline char *getFieldRun(const Dimension::Detail *dd, PointId idx,
+        PointId end, point_count_t& count, std::size_t& stride) const;
+    template<typename T_IN, typename T_OUT>
+    void getFieldsInternal(const Dimension::Detail *dd, PointId begin,
+        PointId end, T_OUT *out) const;
+    template<typename T_IN, typename T_OUT>
+    void setFieldsInternal(const Dimension::Detail *dd, PointId begin,
+        PointId end, const T_IN *in);
     inline PointId getTemp(PointId id);
     void freeTemp(PointId id)
         { m_temps.push(id); }
@@ -302,6 +436,39 @@ T PointView::getFieldInternal(Dimension::Id dim, PointId id) const
     return t;
 }
 
+template<typename T>
+std::vector<ColumnSpan<T>> PointView::columnSpans(Dimension::Id dim) const
+{
+    typedef typename std::remove_const<T>::type ValueType;
+
+    if (!hasColumn<ValueType>(dim))
+    {
+        std::ostringstream oss;
+        oss << "Can't access dimension '" << dimName(dim) << "' as a " <<
+            "column of type '" << Utils::typeidName<ValueType>() << "'.";
+        throw pdal_error(oss.str());
+    }
+
+    ColumnPointTable& table = static_cast<ColumnPointTable&>(m_pointTable);
+    const Dimension::Detail *d = layout()->dimDetail(dim);
+    std::vector<ColumnSpan<T>> spans;
+    PointId idx = 0;
+    while (idx < size())
+    {
+        PointId rawId = m_index[idx];
+        point_count_t avail;
+        T *data = reinterpret_cast<T *>(table.getColumn(d, rawId, avail));
+
+        // Extend the run as long as the view's points are adjacent in
+        // the table.
+        point_count_t count =
+            m_index.runLength(idx, (std::min)(avail, size() - idx));
+        spans.emplace_back(data, count);
+        idx += count;
+    }
+    return spans;
+}
+
 inline void PointView::getField(char *pos, Dimension::Id d,
     Dimension::Type type, PointId id) const
 {
@@ -514,6 +681,187 @@ void PointView::setField(Dimension::Id dim, PointId idx, T val)
     }
 }
 
+// Find the run of points starting at view index 'idx' (and before 'end')
+// whose values can be reached directly in the point table.  Returns NULL
+// if the table doesn't allow direct access.  'count' is always at least 1.
+inline char *PointView::getFieldRun(const Dimension::Detail *dd,
+    PointId idx, PointId end, point_count_t& count, std::size_t& stride) const
+{
+    PointId rawId = m_index[idx];
+    point_count_t avail;
+    char *pos = m_pointTable.getFieldRun(dd, rawId, avail, stride);
+
+    count = pos ? m_index.runLength(idx, (std::min)(avail, end - idx)) : 1;
+    return pos;
+}
+
+
+template<typename T_IN, typename T_OUT>
+void PointView::getFieldsInternal(const Dimension::Detail *dd,
+    PointId begin, PointId end, T_OUT *out) const
+{
+    PointId idx = begin;
+    while (idx < end)
+    {
+        point_count_t count;
+        std::size_t stride;
+        const char *pos = getFieldRun(dd, idx, end, count, stride);
+        for (point_count_t i = 0; i < count; ++i)
+        {
+            T_IN val;
+            if (pos)
+            {
+                std::memcpy(&val, pos, sizeof(T_IN));
+                pos += stride;
+            }
+            else
+                getFieldInternal(dd->id(), idx, &val);
+            if (!Utils::numericCast(val, *out))
+            {
+                std::ostringstream oss;
+                oss << "Unable to fetch data and convert as requested: ";
+                oss << Dimension::name(dd->id()) << ":" <<
+                    Dimension::interpretationName(dd->type()) <<
+                    "(" << (double)val << ") -> " <<
+                    Utils::typeidName<T_OUT>();
+                throw pdal_error(oss.str());
+            }
+            out++;
+        }
+        idx += count;
+    }
+}
+
+
+template<typename T_IN, typename T_OUT>
+void PointView::setFieldsInternal(const Dimension::Detail *dd,
+    PointId begin, PointId end, const T_IN *in)
+{
+    PointId idx = begin;
+    while (idx < end)
+    {
+        point_count_t count;
+        std::size_t stride;
+        char *pos = getFieldRun(dd, idx, end, count, stride);
+        for (point_count_t i = 0; i < count; ++i)
+        {
+            T_OUT val;
+            if (!Utils::numericCast(*in, val))
+            {
+                std::ostringstream oss;
+                oss << "Unable to set data and convert as requested: ";
+                oss << Dimension::name(dd->id()) << ":" <<
+                    Utils::typeidName<T_IN>() << "(" << (double)*in <<
+                    ") -> " << Dimension::interpretationName(dd->type());
+                throw pdal_error(oss.str());
+            }
+            if (pos)
+            {
+                std::memcpy(pos, &val, sizeof(T_OUT));
+                pos += stride;
+            }
+            else
+                m_pointTable.setFieldInternal(dd->id(), m_index[idx], &val);
+            in++;
+        }
+        idx += count;
+    }
+}
+
+
+template<typename T>
+void PointView::getFieldsAs(Dimension::Id dim, PointId begin, PointId end,
+    T *out) const
+{
+    assert(begin <= end && end <= m_size);
+    const Dimension::Detail *dd = layout()->dimDetail(dim);
+
+    switch (dd->type())
+    {
+    case Dimension::Type::Float:
+        getFieldsInternal<float>(dd, begin, end, out);
+        break;
+    case Dimension::Type::Double:
+        getFieldsInternal<double>(dd, begin, end, out);
+        break;
+    case Dimension::Type::Signed8:
+        getFieldsInternal<int8_t>(dd, begin, end, out);
+        break;
+    case Dimension::Type::Signed16:
+        getFieldsInternal<int16_t>(dd, begin, end, out);
+        break;
+    case Dimension::Type::Signed32:
+        getFieldsInternal<int32_t>(dd, begin, end, out);
+        break;
+    case Dimension::Type::Signed64:
+        getFieldsInternal<int64_t>(dd, begin, end, out);
+        break;
+    case Dimension::Type::Unsigned8:
+        getFieldsInternal<uint8_t>(dd, begin, end, out);
+        break;
+    case Dimension::Type::Unsigned16:
+        getFieldsInternal<uint16_t>(dd, begin, end, out);
+        break;
+    case Dimension::Type::Unsigned32:
+        getFieldsInternal<uint32_t>(dd, begin, end, out);
+        break;
+    case Dimension::Type::Unsigned64:
+        getFieldsInternal<uint64_t>(dd, begin, end, out);
+        break;
+    case Dimension::Type::None:
+    default:
+        std::fill(out, out + (end - begin), T(0));
+        break;
+    }
+}
+
+
+template<typename T>
+void PointView::setFields(Dimension::Id dim, PointId begin, PointId end,
+    const T *in)
+{
+    assert(begin <= end && end <= m_size);
+    const Dimension::Detail *dd = layout()->dimDetail(dim);
+    coordsChanged(dim);
+
+    switch (dd->type())
+    {
+    case Dimension::Type::Float:
+        setFieldsInternal<T, float>(dd, begin, end, in);
+        break;
+    case Dimension::Type::Double:
+        setFieldsInternal<T, double>(dd, begin, end, in);
+        break;
+    case Dimension::Type::Signed8:
+        setFieldsInternal<T, int8_t>(dd, begin, end, in);
+        break;
+    case Dimension::Type::Signed16:
+        setFieldsInternal<T, int16_t>(dd, begin, end, in);
+        break;
+    case Dimension::Type::Signed32:
+        setFieldsInternal<T, int32_t>(dd, begin, end, in);
+        break;
+    case Dimension::Type::Signed64:
+        setFieldsInternal<T, int64_t>(dd, begin, end, in);
+        break;
+    case Dimension::Type::Unsigned8:
+        setFieldsInternal<T, uint8_t>(dd, begin, end, in);
+        break;
+    case Dimension::Type::Unsigned16:
+        setFieldsInternal<T, uint16_t>(dd, begin, end, in);
+        break;
+    case Dimension::Type::Unsigned32:
+        setFieldsInternal<T, uint32_t>(dd, begin, end, in);
+        break;
+    case Dimension::Type::Unsigned64:
+        setFieldsInternal<T, uint64_t>(dd, begin, end, in);
+        break;
+    case Dimension::Type::None:
+    default:
+        break;
+    }
+}
+
 /**
 void PointView::setFieldInternal(Dimension::Id dim, PointId idx,
     const void *value)
@@ -547,6 +895,7 @@ inline void PointView::appendPoint(const PointView& buffer, PointId id)
     m_index.push_back(rawId);
     m_size++;
     assert(m_temps.empty());
+    clearSpatialIndex();
 }
 
 
@@ -558,7 +907,7 @@ inline PointId PointView::getTemp(PointId id)
     {
         newid = m_temps.front();
         m_temps.pop();
-        m_index[newid] = m_index[id];
+        m_index.set(newid, m_index[id]);
     }
     else
     {
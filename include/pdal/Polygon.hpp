@@ -114,6 +114,7 @@ private:
 
     void prepare();
 
+    friend class PolygonIndex;
     friend PDAL_DLL std::ostream& operator<<(std::ostream& ostr,
         const Polygon& p);
     friend PDAL_DLL std::istream& operator>>(std::istream& istr,
@@ -0,0 +1,151 @@
+/******************************************************************************
+* Copyright (c) 2016, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <pdal/pdal_internal.hpp>
+#include <pdal/util/Bounds.hpp>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace pdal
+{
+
+class Polygon;
+
+/**
+  A grid over a polygon that answers point-in-polygon queries without
+  calling GEOS.  The polygon's bounds are split into cells of roughly
+  constant size, with a few cells per edge.  A cell that no edge crosses
+  is wholly inside or outside the polygon, which is found once when the
+  index is built.  Only points in cells crossed by an edge need an exact
+  test, which casts a ray against the edges that share the point's row of
+  cells.
+
+  Results match Polygon::covers(): points on the boundary are covered.
+  Queries don't allocate and may be made from several threads at once.
+*/
+class PDAL_DLL PolygonIndex
+{
+public:
+    typedef std::vector<std::pair<double, double>> Ring;
+
+    /**
+      Build an index of a polygon or multipolygon.
+
+      \param poly  Polygon to index.  The index doesn't refer to the
+        polygon once it is built.
+    */
+    PolygonIndex(const Polygon& poly);
+
+    /**
+      Build an index of the area enclosed by a set of rings, using the
+      even-odd rule, so that holes and separate parts may be given in any
+      order.  A ring needn't repeat its first point.
+
+      \param rings  Rings enclosing the area to index.
+    */
+    PolygonIndex(const std::vector<Ring>& rings);
+
+    /**
+      Determine whether a point lies in the polygon or on its boundary.
+
+      \param x  X coordinate of the point.
+      \param y  Y coordinate of the point.
+      \return  Whether the polygon covers the point.
+    */
+    bool covers(double x, double y) const;
+
+    /**
+      Determine whether each of a set of points lies in the polygon or on
+      its boundary.
+
+      \param x  X coordinates of the points.
+      \param y  Y coordinates of the points.
+      \param count  Number of points.
+      \param[out] covered  Set to 1 for each point covered by the polygon
+        and 0 for others.
+    */
+    void covers(const double *x, const double *y, point_count_t count,
+        uint8_t *covered) const;
+
+    /**
+      Return the bounds of the indexed polygon.  The bounds of an empty
+      polygon contain no points.
+
+      \return  Bounds of the polygon.
+    */
+    BOX2D bounds() const
+        { return BOX2D(m_minx, m_miny, m_maxx, m_maxy); }
+
+private:
+    struct Edge
+    {
+        double x0;
+        double y0;
+        double x1;
+        double y1;
+    };
+
+    enum class CellState : uint8_t
+    {
+        Outside,
+        Inside,
+        Boundary
+    };
+
+    std::vector<Edge> m_edges;
+    double m_minx;
+    double m_miny;
+    double m_maxx;
+    double m_maxy;
+    double m_cellWidth;
+    double m_cellHeight;
+    int m_rows;
+    int m_cols;
+    std::vector<CellState> m_cells;
+    // Edges crossing each cell and each row of cells, in compressed
+    // sparse row form.
+    std::vector<std::size_t> m_cellOffsets;
+    std::vector<uint32_t> m_cellEdges;
+    std::vector<std::size_t> m_rowOffsets;
+    std::vector<uint32_t> m_rowEdges;
+
+    void build(const std::vector<Ring>& rings);
+    bool exactCovers(int row, int cell, double x, double y) const;
+};
+
+} // namespace pdal
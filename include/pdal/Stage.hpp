@@ -58,6 +58,10 @@ class ProgramArgs;
 class StageRunner;
 class StageWrapper;
 
+/// Per-point flags used in streaming mode.  A non-zero entry marks a point
+/// that has been filtered out and should be ignored by subsequent stages.
+typedef std::vector<uint8_t> SkipMask;
+
 /**
   A stage performs the actual processing in PDAL.  Stages may read data,
   modify or filter read data, create metadata or write processed data.
@@ -113,7 +117,9 @@ public:
 
       This performs the action associated with the stage by executing the
       \ref run function of each stage in depth first order.  Each stage is run
-      to completion (all points are processed) before the next stages is run.o
+      to completion (all points are processed) before the next stages is run.
+      Stages that are \ref parallelSafe run their input views concurrently
+      on up to \ref threads threads.
 
       \param table  Point table being used for stage pipeline.  This must be
         the same \ref table used in the \ref prepare function.
@@ -124,7 +130,7 @@ public:
       Execute a prepared pipeline (linked set of stages) in streaming mode.
 
       This performs the action associated with the stage by executing the
-      \ref processOne function of each stage in depth first order.  Points
+      \ref processBatch function of each stage in depth first order.  Points
       are processed up to the capacity of the provided StreamPointTable.
       Not all stages support streaming mode and an exception will be thrown
       when attempting to \ref execute an unsupported stage.
@@ -132,6 +138,15 @@ public:
       Streaming points can reduce memory consumption, but may limit access
       to algorithms that need to operate on full point sets.
 
+      If this stage's "pipeline_threads" option is set to something other
+      than 1, the stages of each path are split into groups that run on
+      their own threads and pass batches of points to one another, in
+      order, through a small ring of internal tables with the capacity of
+      \a table.  In that case the points are never placed in \a table
+      itself, so the last stage should consume them (a writer or a
+      callback filter).  The stage's \ref threads setting doesn't enable
+      pipelining.
+
       \param table  Streming point table used for stage pipeline.  This must be
         the same \ref table used in the \ref prepare function.
 
@@ -237,6 +252,25 @@ public:
     void popLogLeader() const
         { m_log->popLeader(); }
 
+    /**
+      Return the number of threads the stage may use to process points.
+      Set with the "threads" option.  When the stage's input views are run
+      concurrently, the threads running them already share the option's
+      threads, so 1 is returned on those threads.
+
+      \return  Number of threads.
+    */
+    std::size_t threads() const;
+
+    /**
+      Determine whether this stage and all the stages that feed it can
+      process points in streaming mode.
+
+      \return  Whether the pipeline ending at this stage can be run with
+        a StreamPointTable.
+    */
+    bool pipelineStreamable() const;
+
     /**
       Determine whether the stage is in debug mode or not.
 
@@ -302,6 +336,8 @@ protected:
 private:
     bool m_debug;
     uint32_t m_verbose;
+    std::size_t m_threads;
+    std::size_t m_pipelineThreads;
     std::string m_logname;
     std::vector<Stage *> m_inputs;
     LogPtr m_log;
@@ -314,6 +350,7 @@ private:
 
     void setupLog();
     void handleOptions();
+    static void setViewThread(bool viewThread);
 
     virtual void readerAddArgs(ProgramArgs& /*args*/)
         {}
@@ -393,6 +430,16 @@ private:
     virtual void ready(PointTableRef /*table*/)
         {}
 
+    /**
+      Determine whether the stage can process points in streaming mode.
+      Stages that implement \ref processOne or \ref processBatch should
+      override this to return true.
+
+      \return  Whether the stage supports streaming.
+    */
+    virtual bool streamable() const
+        { return false; }
+
     /**
       Process a single point (streaming mode).  Implement in sublcass.
 
@@ -408,6 +455,25 @@ private:
         throw pdal_error(oss.str());
     }
 
+    /**
+      Process a batch of points (streaming mode).  The default
+      implementation calls \ref processOne for each point.  Implement in
+      subclass when points can be handled more efficiently in bulk.
+
+      Readers load points into the table starting at index 0 and return
+      the number of points read, which is less than \a count only when
+      there are no more points.  Filters and writers process each point
+      in the range [0, count) whose entry in \a skips is zero and set the
+      entry for any point that is filtered out.
+
+      \param table  Table holding the points of the batch.
+      \param count  Number of points in the batch.
+      \param skips  Skip flags, one per point in the table.
+      \return  Number of points read (readers) or \a count.
+    */
+    virtual point_count_t processBatch(StreamPointTable& table,
+        point_count_t count, SkipMask& skips);
+
     /**
       Process all points in a view.  Implement in subclass.
 
@@ -419,6 +485,16 @@ private:
         return PointViewSet();
     }
 
+    /**
+      Determine whether \ref run may be called for several point views at
+      the same time.  Stages that keep no per-view state in members can
+      override this to have views processed on the stage's threads.
+
+      \return  Whether views can be run in parallel.
+    */
+    virtual bool parallelSafe() const
+        { return false; }
+
     /**
       Called after all point views have been processed.  Implement in subclass.
 
@@ -428,6 +504,8 @@ private:
         {}
 
     void execute(StreamPointTable& table, std::list<Stage *>& stages);
+    void executePipelined(StreamPointTable& table,
+        std::list<Stage *>& stages, std::size_t numThreads);
 
     /*
       Test hook.
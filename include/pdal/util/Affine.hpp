@@ -0,0 +1,95 @@
+/******************************************************************************
+* Copyright (c) 2016, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+#include "pdal_util_export.hpp"
+
+namespace pdal
+{
+
+/**
+  Apply an affine transformation to points whose coordinates are stored
+  in separate arrays, in place.  Each point (x, y, z) becomes
+
+      x' = m[0] * x + m[1] * y + m[2]  * z + m[3]
+      y' = m[4] * x + m[5] * y + m[6]  * z + m[7]
+      z' = m[8] * x + m[9] * y + m[10] * z + m[11]
+
+  The work is done with the widest SIMD instructions that the processor
+  supports (AVX or SSE2 on x86), chosen when first called, or with plain
+  code elsewhere.  Results are the same with all instruction sets.
+
+  \param m  The first three rows of a 4x4 transformation matrix stored in
+    row-major order (12 values).
+  \param count  Number of points.
+  \param x  X coordinates of the points.
+  \param y  Y coordinates of the points.
+  \param z  Z coordinates of the points.
+*/
+PDAL_DLL void affineTransform(const double *m, std::size_t count, double *x,
+    double *y, double *z);
+
+/**
+  Instruction sets with which \ref affineTransform can do its work.
+*/
+enum class AffineKernel
+{
+    Scalar,
+    Sse2,
+    Avx
+};
+
+/**
+  Apply an affine transformation as \ref affineTransform does, but with a
+  particular instruction set.  This allows the results of the instruction
+  sets to be compared with each other.
+
+  \param kernel  Instruction set to use.
+  \param m  The first three rows of a 4x4 transformation matrix stored in
+    row-major order (12 values).
+  \param count  Number of points.
+  \param x  X coordinates of the points.
+  \param y  Y coordinates of the points.
+  \param z  Z coordinates of the points.
+  \return  Whether the points were transformed.  False, leaving the points
+    alone, when the library wasn't built with the instruction set or the
+    processor doesn't support it.
+*/
+PDAL_DLL bool affineTransform(AffineKernel kernel, const double *m,
+    std::size_t count, double *x, double *y, double *z);
+
+} // namespace pdal
@@ -51,6 +51,45 @@ namespace pdal
 
 namespace FileUtils
 {
+    /**
+      Read-only memory mapping of a file, created with \ref mapFile.
+    */
+    struct MapContext
+    {
+        MapContext() : m_fd(-1), m_handle(NULL), m_addr(NULL), m_size(0)
+        {}
+
+        /**
+          Return the address of the start of the mapped file.
+
+          \return  Address of mapped data, or NULL if the map failed.
+        */
+        const char *addr() const
+            { return (const char *)m_addr; }
+
+        /**
+          Return the number of mapped bytes.
+
+          \return  Size of the mapped file.
+        */
+        uint64_t size() const
+            { return m_size; }
+
+        /**
+          Return a description of the error if the map failed.
+
+          \return  Error message.
+        */
+        std::string what() const
+            { return m_error; }
+
+        int m_fd;
+        void *m_handle;
+        void *m_addr;
+        uint64_t m_size;
+        std::string m_error;
+    };
+
     /**
       Open an existing file for reading.
 
@@ -243,6 +282,24 @@ namespace FileUtils
       \return  Stem of filename.
     */
     PDAL_DLL std::string stem(const std::string& path);
+
+    /**
+      Map an entire existing file into memory for reading.  Points into
+      the map can be decoded without copying file data through a stream.
+
+      \param filename  Name of file to map.
+      \return  Context of the mapping.  On failure, addr() is NULL and
+        what() describes the error.
+    */
+    PDAL_DLL MapContext mapFile(const std::string& filename);
+
+    /**
+      Unmap a file mapped with \ref mapFile.
+
+      \param ctx  Context of the mapping to release.
+      \return  Context with the mapping cleared.
+    */
+    PDAL_DLL MapContext unmapFile(MapContext ctx);
 }
 
 } // namespace pdal
@@ -0,0 +1,139 @@
+/******************************************************************************
+* Copyright (c) 2016, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "pdal_util_export.hpp"
+
+namespace pdal
+{
+
+/**
+  A pool of worker threads that execute queued tasks.
+
+  Each worker has its own task queue.  Tasks are distributed round-robin
+  to the queues when added, and a worker whose queue is empty steals tasks
+  from the back of the other workers' queues.  A pool created with a single
+  thread runs each task synchronously in \ref add.
+*/
+class PDAL_DLL ThreadPool
+{
+public:
+    typedef std::function<void()> Task;
+
+    /**
+      Create a pool of threads.
+
+      \param numThreads  Number of worker threads.  If zero, the number of
+        hardware threads is used.
+    */
+    ThreadPool(std::size_t numThreads);
+
+    /**
+      Wait for all queued tasks to complete and stop the worker threads.
+    */
+    ~ThreadPool();
+
+    /**
+      Queue a task for execution.
+
+      \param task  Task to run.
+    */
+    void add(Task task);
+
+    /**
+      Wait for all queued tasks to complete.  If any task threw an
+      exception, the first such exception is rethrown.  Must not be called
+      from a task running in this pool.
+    */
+    void await();
+
+    /**
+      Return the number of worker threads.
+
+      \return  Number of threads in the pool.
+    */
+    std::size_t numThreads() const
+        { return m_numThreads; }
+
+    /**
+      Return the default number of threads used when processing point data.
+      This is the value of the PDAL_NUM_THREADS environment variable if it
+      is set, otherwise 1.
+
+      \return  Default number of threads.
+    */
+    static std::size_t defaultThreads();
+
+private:
+    struct Queue
+    {
+        std::mutex m_mutex;
+        std::deque<Task> m_tasks;
+    };
+
+    std::size_t m_numThreads;
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::atomic<std::size_t> m_next;
+
+    // Protects m_queued, m_outstanding, m_stop and m_error.
+    std::mutex m_mutex;
+    std::condition_variable m_workCv;
+    std::condition_variable m_doneCv;
+    std::size_t m_queued;
+    std::size_t m_outstanding;
+    bool m_stop;
+    std::exception_ptr m_error;
+
+    void work(std::size_t id);
+    bool pop(std::size_t id, Task& task);
+    void runTask(Task& task);
+
+    ThreadPool& operator=(const ThreadPool&); // not implemented
+    ThreadPool(const ThreadPool&); // not implemented
+};
+
+} // namespace pdal
@@ -41,6 +41,8 @@
 #include <pdal/Options.hpp>
 #include <pdal/pdal_export.hpp>
 #include <pdal/pdal_macros.hpp>
+#include <pdal/util/Extractor.hpp>
+#include <pdal/util/ProgramArgs.hpp>
 
 namespace pdal
 {
@@ -56,6 +58,13 @@ CREATE_STATIC_PLUGIN(1, 0, BpfReader, Reader, s_info)
 
 std::string BpfReader::getName() const { return s_info.name; }
 
+void BpfReader::addArgs(ProgramArgs& args)
+{
+    args.add("use_mmap", "Read uncompressed point-major data through a "
+        "memory map of the file", m_useMmap, false);
+}
+
+
 QuickInfo BpfReader::inspect()
 {
     QuickInfo qi;
@@ -254,16 +263,37 @@ void BpfReader::ready(PointTableRef)
         m_charbuf.initialize(m_deflateBuf.data(), m_deflateBuf.size(), m_start);
         m_stream.pushStream(new std::istream(&m_charbuf));
     }
+    else if (m_useMmap && m_header.m_pointFormat == BpfFormat::PointMajor)
+    {
+        m_map = FileUtils::mapFile(m_filename);
+        uint64_t end = (uint64_t)m_start +
+            (uint64_t)numPoints() * m_dims.size() * sizeof(float);
+        if (!m_map.addr() || m_map.size() < end)
+        {
+            log()->get(LogLevel::Warning) << getName() << ": Unable to map '" <<
+                m_filename << "'. " << m_map.what() << " Reading from stream." <<
+                std::endl;
+            m_map = FileUtils::unmapFile(m_map);
+        }
+    }
 }
 
 
 void BpfReader::done(PointTableRef)
 {
+     m_map = FileUtils::unmapFile(m_map);
      delete m_stream.popStream();
      m_stream.close();
 }
 
 
+// Address of point data in the mapped file.
+const char *BpfReader::mappedData(std::size_t offset) const
+{
+    return m_map.addr() + (std::size_t)m_start + offset;
+}
+
+
 bool BpfReader::processOne(PointRef& point)
 {
     switch (m_header.m_pointFormat)
@@ -322,15 +352,31 @@ bool BpfReader::eof()
 
 
 void BpfReader::readPointMajor(PointRef& point)
+{
+    if (m_map.addr())
+    {
+        const size_t ptLen = sizeof(float) * m_dims.size();
+        LeExtractor in(mappedData(m_index * ptLen), ptLen);
+        readPointMajor(in, point);
+    }
+    else
+    {
+        seekPointMajor(m_index);
+        readPointMajor(m_stream, point);
+    }
+}
+
+
+template<typename IN>
+void BpfReader::readPointMajor(IN& in, PointRef& point)
 {
     double x(0), y(0), z(0);
 
-    seekPointMajor(m_index);
     for (size_t dim = 0; dim < m_dims.size(); ++dim)
     {
         float f;
 
-        m_stream >> f;
+        in >> f;
         double d = f + m_dims[dim].m_offset;
         if (m_dims[dim].m_id == Dimension::Id::X)
             x = d;
@@ -351,18 +397,34 @@ void BpfReader::readPointMajor(PointRef& point)
 
 
 point_count_t BpfReader::readPointMajor(PointViewPtr view, point_count_t count)
+{
+    if (m_map.addr())
+    {
+        // Decode straight from the mapped pages.
+        const size_t ptLen = sizeof(float) * m_dims.size();
+        LeExtractor in(mappedData(m_index * ptLen),
+            (numPoints() - m_index) * ptLen);
+        return readPointMajor(in, view, count);
+    }
+    seekPointMajor(m_index);
+    return readPointMajor(m_stream, view, count);
+}
+
+
+template<typename IN>
+point_count_t BpfReader::readPointMajor(IN& in, PointViewPtr view,
+    point_count_t count)
 {
     PointId nextId = view->size();
     PointId idx = m_index;
     point_count_t numRead = 0;
-    seekPointMajor(idx);
     while (numRead < count && idx < numPoints())
     {
         for (size_t d = 0; d < m_dims.size(); ++d)
         {
             float f;
 
-            m_stream >> f;
+            in >> f;
             view->setField(m_dims[d].m_id, nextId, f + m_dims[d].m_offset);
         }
 
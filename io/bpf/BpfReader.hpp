@@ -41,6 +41,7 @@
 
 #include <pdal/Reader.hpp>
 #include <pdal/util/Charbuf.hpp>
+#include <pdal/util/FileUtils.hpp>
 #include <pdal/util/IStream.hpp>
 #include <pdal/pdal_export.hpp>
 #include <pdal/plugin.hpp>
@@ -81,11 +82,19 @@ private:
     std::vector<char> m_deflateBuf;
     /// Streambuf for deflated data.
     Charbuf m_charbuf;
+    /// Whether to read uncompressed data through a memory map.
+    bool m_useMmap;
+    /// Memory map of the file.
+    FileUtils::MapContext m_map;
+
+    virtual void addArgs(ProgramArgs& args);
 
     virtual QuickInfo inspect();
     virtual void initialize();
     virtual void addDimensions(PointLayoutPtr Layout);
     virtual void ready(PointTableRef table);
+    virtual bool streamable() const
+        { return true; }
     virtual bool processOne(PointRef& point);
     virtual point_count_t read(PointViewPtr data, point_count_t num);
     virtual void done(PointTableRef table);
@@ -95,7 +104,12 @@ private:
     bool readHeaderExtraData();
     bool readPolarData();
     void readPointMajor(PointRef& point);
+    template<typename IN>
+    void readPointMajor(IN& in, PointRef& point);
     point_count_t readPointMajor(PointViewPtr data, point_count_t count);
+    template<typename IN>
+    point_count_t readPointMajor(IN& in, PointViewPtr data,
+        point_count_t count);
     void readDimMajor(PointRef& point);
     point_count_t readDimMajor(PointViewPtr data, point_count_t count);
     void readByteMajor(PointRef& point);
@@ -104,6 +118,7 @@ private:
     bool eof();
     int inflate(char *inbuf, uint32_t insize, char *outbuf, uint32_t outsize);
 
+    const char *mappedData(std::size_t offset) const;
     void seekPointMajor(PointId ptIdx);
     void seekDimMajor(size_t dimIdx, PointId ptIdx);
     void seekByteMajor(size_t dimIdx, size_t byteIdx, PointId ptIdx);
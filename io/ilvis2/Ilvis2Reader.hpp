@@ -91,6 +91,8 @@ private:
     virtual void initialize(PointTableRef table);
     virtual void ready(PointTableRef table);
     virtual void done(PointTableRef table);
+    virtual bool streamable() const
+        { return true; }
     virtual bool processOne(PointRef& point);
     virtual point_count_t read(PointViewPtr view, point_count_t count);
 
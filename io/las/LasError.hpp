@@ -33,6 +33,7 @@
 
 #pragma once
 
+#include <mutex>
 #include <vector>
 
 #include <pdal/util/Algorithm.hpp>
@@ -55,7 +56,10 @@ public:
     void returnNumWarning(int returnNum)
     {
         static std::vector<int> warned;
+        static std::mutex mutex;
 
+        // Points may be loaded by several threads at once.
+        std::lock_guard<std::mutex> lock(mutex);
         if (!Utils::contains(warned, returnNum))
         {
             warned.push_back(returnNum);
@@ -68,7 +72,9 @@ public:
     void numReturnsWarning(int numReturns)
     {
         static std::vector<int> warned;
+        static std::mutex mutex;
 
+        std::lock_guard<std::mutex> lock(mutex);
         if (!Utils::contains(warned, numReturns))
         {
             warned.push_back(numReturns);
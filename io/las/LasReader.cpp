@@ -34,6 +34,7 @@
 
 #include "LasReader.hpp"
 
+#include <limits>
 #include <sstream>
 #include <string.h>
 
@@ -44,6 +45,7 @@
 #include <pdal/util/IStream.hpp>
 #include <pdal/pdal_macros.hpp>
 #include <pdal/util/ProgramArgs.hpp>
+#include <pdal/util/ThreadPool.hpp>
 
 #ifdef PDAL_HAVE_LIBGEOTIFF
 #include "GeotiffSupport.hpp"
@@ -73,6 +75,8 @@ void LasReader::addArgs(ProgramArgs& args)
     args.add("extra_dims", "Dimensions to assign to extra byte data",
         m_extraDimSpec);
     args.add("compression", "Decompressor to use", m_compression, "LASZIP");
+    args.add("use_mmap", "Read uncompressed points through a memory map "
+        "of the file", m_useMmap);
 }
 
 
@@ -226,7 +230,35 @@ void LasReader::ready(PointTableRef table)
 #endif
     }
     else
+    {
         stream->seekg(m_header.pointOffset());
+        if (m_useMmap)
+        {
+            m_map = FileUtils::mapFile(m_filename);
+            uint64_t start = fileOffset() + m_header.pointOffset();
+            if (!m_map.addr() || m_map.size() < start)
+            {
+                log()->get(LogLevel::Warning) << getName() << ": Unable to "
+                    "map '" << m_filename << "'. " << m_map.what() <<
+                    " Reading from stream." << std::endl;
+                m_map = FileUtils::unmapFile(m_map);
+            }
+            else
+            {
+                // A file may be shorter than its header claims.
+                m_mappedPoints = std::min<point_count_t>(getNumPoints(),
+                    (m_map.size() - start) / m_header.pointLen());
+            }
+        }
+    }
+}
+
+
+// Address of a point's record in the mapped file.
+const char *LasReader::mappedPoint(PointId idx) const
+{
+    return m_map.addr() + fileOffset() + m_header.pointOffset() +
+        idx * m_header.pointLen();
 }
 
 
@@ -512,6 +544,12 @@ bool LasReader::processOne(PointRef& point)
             "LAZperf decompression library.");
 #endif
     } // compression
+    else if (m_map.addr())
+    {
+        if (m_index >= m_mappedPoints)
+            return false;
+        loadPoint(point, mappedPoint(m_index), pointLen);
+    }
     else
     {
         std::vector<char> buf(m_header.pointLen());
@@ -524,6 +562,61 @@ bool LasReader::processOne(PointRef& point)
 }
 
 
+// Uncompressed points are read from the file as a single block and
+// unpacked into the table.
+point_count_t LasReader::processBatch(StreamPointTable& table,
+    point_count_t count, SkipMask& /*skips*/)
+{
+    count = std::min(count, getNumPoints() - m_index);
+
+    PointRef point(table, 0);
+    if (m_header.compressed())
+    {
+        for (PointId idx = 0; idx < count; ++idx)
+        {
+            point.setPointId(idx);
+            processOne(point);
+        }
+        return count;
+    }
+
+    size_t pointLen = m_header.pointLen();
+    if (m_map.addr())
+    {
+        // Decode straight from the mapped pages.
+        count = std::min(count, m_mappedPoints - m_index);
+        for (PointId idx = 0; idx < count; ++idx)
+        {
+            point.setPointId(idx);
+            loadPoint(point, mappedPoint(m_index + idx), pointLen);
+        }
+        m_index += count;
+        return count;
+    }
+
+    m_batchBuf.resize(count * pointLen);
+
+    point_count_t numRead = 0;
+    try
+    {
+        if (count)
+            numRead = readFileBlock(m_batchBuf, count);
+    }
+    catch (invalid_stream&)
+    {}
+
+    char *pos = m_batchBuf.data();
+    for (PointId idx = 0; idx < numRead; ++idx)
+    {
+        point.setPointId(idx);
+        loadPoint(point, pos, pointLen);
+        pos += pointLen;
+    }
+    m_index += numRead;
+    return numRead;
+}
+
+
 point_count_t LasReader::read(PointViewPtr view, point_count_t count)
 {
     size_t pointLen = m_header.pointLen();
@@ -533,6 +626,16 @@ point_count_t LasReader::read(PointViewPtr view, point_count_t count)
     if (m_header.compressed())
     {
 #if defined(PDAL_HAVE_LAZPERF) || defined(PDAL_HAVE_LASZIP)
+#ifdef PDAL_HAVE_LASZIP
+        // Variably sized chunks can't be located without decoding them,
+        // so only files with a fixed chunk size are read in parallel.
+        const uint32_t chunkSize = m_zipPoint ?
+            m_zipPoint->GetZipper()->chunk_size : 0;
+        if (m_compression == "LASZIP" && threads() != 1 && count &&
+            chunkSize && chunkSize != (std::numeric_limits<uint32_t>::max)())
+            i = readZipChunks(view, count);
+        else
+#endif
         if (m_compression == "LASZIP" || m_compression == "LAZPERF")
         {
             for (i = 0; i < count; i++)
@@ -549,6 +652,18 @@ point_count_t LasReader::read(PointViewPtr view, point_count_t count)
             "LAZperf decompression library.");
 #endif
     }
+    else if (m_map.addr())
+    {
+        count = std::min(count, m_mappedPoints - m_index);
+        for (i = 0; i < count; i++)
+        {
+            PointId id = view->size();
+            PointRef point = view->point(id);
+            loadPoint(point, mappedPoint(m_index + i), pointLen);
+            if (m_cb)
+                m_cb(*view, id);
+        }
+    }
     else
     {
         point_count_t remaining = count;
@@ -586,6 +701,106 @@ point_count_t LasReader::read(PointViewPtr view, point_count_t count)
 }
 
 
+// Decompress the points of a LASzip file on several threads.  Each thread
+// opens its own stream and decompressor and seeks to the start of its
+// range of chunks.  Points are added to the view in order before decoding
+// so that threads write to distinct, already existing points.  Threads
+// write straight to the point table so that they don't touch the view's
+// spatial index, which is discarded once here instead.
+point_count_t LasReader::readZipChunks(PointViewPtr view, point_count_t count)
+{
+#ifdef PDAL_HAVE_LASZIP
+    const point_count_t chunkSize = m_zipPoint->GetZipper()->chunk_size;
+
+    ThreadPool pool(threads());
+
+    // Split the points into ranges that start and end on chunk boundaries.
+    const point_count_t first = m_index;
+    const point_count_t last = m_index + count;
+    point_count_t numChunks = (last - 1) / chunkSize - first / chunkSize + 1;
+    point_count_t numRanges = std::min<point_count_t>(numChunks,
+        pool.numThreads());
+    std::vector<point_count_t> bounds;
+    bounds.push_back(first);
+    for (point_count_t r = 1; r < numRanges; ++r)
+    {
+        point_count_t chunk = first / chunkSize + (numChunks * r) / numRanges;
+        bounds.push_back(chunk * chunkSize);
+    }
+    bounds.push_back(last);
+
+    const PointId start = view->size();
+    for (PointId idx = start; idx < start + count; ++idx)
+        view->setField(Dimension::Id::X, idx, 0);
+    view->clearSpatialIndex();
+
+    VariableLengthRecord *vlr = m_header.findVlr(LASZIP_USER_ID,
+        LASZIP_RECORD_ID);
+    const size_t pointLen = m_header.pointLen();
+    for (point_count_t r = 0; r < numRanges; ++r)
+    {
+        point_count_t begin = bounds[r];
+        point_count_t end = bounds[r + 1];
+        pool.add([this, &view, vlr, pointLen, begin, end, first, start]()
+        {
+            std::unique_ptr<LasStreamIf> streamIf(openStream());
+            std::istream *stream(streamIf->m_istream);
+            stream->seekg(m_header.pointOffset(), std::ios::beg);
+
+            ZipPoint zipPoint(vlr);
+            LASunzipper unzipper;
+            bool ok = unzipper.open(*stream, zipPoint.GetZipper());
+            if (ok && !unzipper.seek((unsigned int)begin))
+            {
+                const char* err = unzipper.get_error();
+                throw pdal_error(std::string("Unable to seek to compressed "
+                    "point ") + std::to_string(begin) + ": " +
+                    (err ? err : "(unknown error)"));
+            }
+            for (point_count_t idx = begin; ok && idx < end; ++idx)
+            {
+                ok = unzipper.read(zipPoint.m_lz_point);
+                if (ok)
+                {
+                    PointRef point = view->tablePoint(start + idx - first);
+                    loadPoint(point, (char *)zipPoint.m_lz_point_data.data(),
+                        pointLen);
+                }
+            }
+            if (!ok)
+            {
+                std::string error = "Error reading compressed point data: ";
+                const char* err = unzipper.get_error();
+                if (!err)
+                    err = "(unknown error)";
+                error += err;
+                throw pdal_error(error);
+            }
+            unzipper.close();
+        });
+    }
+    pool.await();
+
+    // Leave the reader's own decompressor after the points just read.
+    // There's nothing to seek to once all the points have been read.
+    if (last < m_header.pointCount() &&
+        !m_unzipper->seek((unsigned int)last))
+    {
+        const char* err = m_unzipper->get_error();
+        throw pdal_error(std::string("Unable to seek to compressed "
+            "point ") + std::to_string(last) + ": " +
+            (err ? err : "(unknown error)"));
+    }
+    if (m_cb)
+        for (PointId idx = start; idx < start + count; ++idx)
+            m_cb(*view, idx);
+    return count;
+#else
+    return 0;
+#endif
+}
+
+
 point_count_t LasReader::readFileBlock(std::vector<char>& buf,
     point_count_t maxpoints)
 {
@@ -610,7 +825,7 @@ point_count_t LasReader::readFileBlock(std::vector<char>& buf,
 }
 
 
-void LasReader::loadPoint(PointRef& point, char *buf, size_t bufsize)
+void LasReader::loadPoint(PointRef& point, const char *buf, size_t bufsize)
 {
     if (m_header.has14Format())
         loadPointV14(point, buf, bufsize);
@@ -619,7 +834,7 @@ void LasReader::loadPoint(PointRef& point, char *buf, size_t bufsize)
 }
 
 
-void LasReader::loadPointV10(PointRef& point, char *buf, size_t bufsize)
+void LasReader::loadPointV10(PointRef& point, const char *buf, size_t bufsize)
 {
     LeExtractor istream(buf, bufsize);
 
@@ -687,7 +902,7 @@ void LasReader::loadPointV10(PointRef& point, char *buf, size_t bufsize)
 
 }
 
-void LasReader::loadPointV14(PointRef& point, char *buf, size_t bufsize)
+void LasReader::loadPointV14(PointRef& point, const char *buf, size_t bufsize)
 {
     LeExtractor istream(buf, bufsize);
 
@@ -788,6 +1003,7 @@ void LasReader::done(PointTableRef)
     m_zipPoint.reset();
     m_unzipper.reset();
 #endif
+    m_map = FileUtils::unmapFile(m_map);
     m_streamIf.reset();
 }
 
@@ -39,6 +39,7 @@
 #include <pdal/Compression.hpp>
 #include <pdal/PDALUtils.hpp>
 #include <pdal/Reader.hpp>
+#include <pdal/util/FileUtils.hpp>
 
 #include "LasError.hpp"
 #include "LasHeader.hpp"
@@ -80,7 +81,8 @@ protected:
 
     friend class NitfReader;
 public:
-    LasReader() : pdal::Reader(), m_index(0)
+    LasReader() : pdal::Reader(), m_index(0), m_useMmap(false),
+        m_mappedPoints(0)
         {}
 
     static void * create();
@@ -97,16 +99,28 @@ protected:
     {
         if (m_streamIf)
             std::cerr << "Attempt to create stream twice!\n";
-        m_streamIf.reset(new LasStreamIf(m_filename));
-        if (!m_streamIf->m_istream)
+        m_streamIf.reset(openStream());
+    }
+
+    // Open a new stream positioned at the start of the LAS data.  Streams
+    // beyond m_streamIf are opened to decompress chunks in parallel.
+    virtual LasStreamIf *openStream()
+    {
+        std::unique_ptr<LasStreamIf> streamIf(new LasStreamIf(m_filename));
+        if (!streamIf->m_istream)
         {
             std::ostringstream oss;
             oss << "Unable to create open stream for '"
                 << m_filename <<"' with error '" << strerror(errno) <<"'";
             throw pdal_error(oss.str());
         }
+        return streamIf.release();
     }
 
+    // Offset of the LAS data from the start of the file named by m_filename.
+    virtual uint64_t fileOffset() const
+        { return 0; }
+
     std::unique_ptr<LasStreamIf> m_streamIf;
 
 private:
@@ -116,10 +130,14 @@ private:
     std::unique_ptr<LASunzipper> m_unzipper;
     std::unique_ptr<LazPerfVlrDecompressor> m_decompressor;
     std::vector<char> m_decompressorBuf;
+    std::vector<char> m_batchBuf;
     point_count_t m_index;
     StringList m_extraDimSpec;
     std::vector<ExtraDim> m_extraDims;
     std::string m_compression;
+    bool m_useMmap;
+    FileUtils::MapContext m_map;
+    point_count_t m_mappedPoints;
 
     virtual void addArgs(ProgramArgs& args);
     virtual void initialize(PointTableRef table)
@@ -129,18 +147,24 @@ private:
     virtual QuickInfo inspect();
     virtual void ready(PointTableRef table);
     virtual point_count_t read(PointViewPtr view, point_count_t count);
+    point_count_t readZipChunks(PointViewPtr view, point_count_t count);
+    virtual bool streamable() const
+        { return true; }
     virtual bool processOne(PointRef& point);
+    virtual point_count_t processBatch(StreamPointTable& table,
+        point_count_t count, SkipMask& skips);
     virtual void done(PointTableRef table);
     virtual bool eof()
         { return m_index >= getNumPoints(); }
 
     void setSrs(MetadataNode& m);
+    const char *mappedPoint(PointId idx) const;
     void readExtraBytesVlr();
     void extractHeaderMetadata(MetadataNode& forward, MetadataNode& m);
     void extractVlrMetadata(MetadataNode& forward, MetadataNode& m);
-    void loadPoint(PointRef& point, char *buf, size_t bufsize);
-    void loadPointV10(PointRef& point, char *buf, size_t bufsize);
-    void loadPointV14(PointRef& point, char *buf, size_t bufsize);
+    void loadPoint(PointRef& point, const char *buf, size_t bufsize);
+    void loadPointV10(PointRef& point, const char *buf, size_t bufsize);
+    void loadPointV14(PointRef& point, const char *buf, size_t bufsize);
     void loadExtraDims(LeExtractor& istream, PointRef& data);
     point_count_t readFileBlock(std::vector<char>& buf,
         point_count_t maxPoints);
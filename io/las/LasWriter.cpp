@@ -619,6 +619,12 @@ void LasWriter::readyLazPerfCompression()
 
     m_compressor.reset(new LazPerfVlrCompressor(*m_ostream, schema,
         zipvlr.chunk_size));
+
+    // With more than one thread, points are buffered and whole chunks
+    // are compressed in parallel.
+    m_chunkBuf.clear();
+    if (threads() != 1)
+        m_pool.reset(new ThreadPool(threads()));
 #endif
 }
 
@@ -659,6 +665,38 @@ bool LasWriter::processOne(PointRef& point)
 }
 
 
+// Pack all the points of the batch and write them in one go.
+point_count_t LasWriter::processBatch(StreamPointTable& table,
+    point_count_t count, SkipMask& skips)
+{
+    size_t pointLen = m_lasHeader.pointLen();
+    if (m_pointBuf.size() < count * pointLen)
+        m_pointBuf.resize(count * pointLen);
+
+    LeInserter ostream(m_pointBuf.data(), m_pointBuf.size());
+    PointRef point(table, 0);
+    point_count_t filled = 0;
+    for (PointId idx = 0; idx < count; ++idx)
+    {
+        if (skips[idx])
+            continue;
+        point.setPointId(idx);
+        if (fillPointBuf(point, ostream))
+            filled++;
+        else
+            skips[idx] = 1;
+    }
+
+    if (m_compression == LasCompression::LasZip)
+        writeLasZipBuf(m_pointBuf.data(), pointLen, filled);
+    else if (m_compression == LasCompression::LazPerf)
+        writeLazPerfBuf(m_pointBuf.data(), pointLen, filled);
+    else
+        m_ostream->write(m_pointBuf.data(), filled * pointLen);
+    return count;
+}
+
+
 void LasWriter::writeView(const PointViewPtr view)
 {
     Utils::writeProgress(m_progressFd, "READYVIEW",
@@ -717,6 +755,17 @@ void LasWriter::writeLazPerfBuf(char *pos, size_t pointLen,
     point_count_t numPts)
 {
 #ifdef PDAL_HAVE_LAZPERF
+    if (m_pool)
+    {
+        m_chunkBuf.insert(m_chunkBuf.end(), pos, pos + numPts * pointLen);
+
+        // Wait until there's a whole chunk for each thread.
+        point_count_t bufPts = m_chunkBuf.size() / pointLen;
+        if (bufPts >= m_compressor->chunkSize() * m_pool->numThreads())
+            writeLazPerfChunks(false);
+        return;
+    }
+
     for (point_count_t i = 0; i < numPts; i++)
     {
         m_compressor->compress(pos);
@@ -726,6 +775,40 @@ void LasWriter::writeLazPerfBuf(char *pos, size_t pointLen,
 }
 
 
+// Compress the buffered points a chunk per task and write the chunks in
+// order.  Unless flushing, a partial chunk is left in the buffer.
+void LasWriter::writeLazPerfChunks(bool flush)
+{
+#ifdef PDAL_HAVE_LAZPERF
+    const size_t pointLen = m_lasHeader.pointLen();
+    const point_count_t chunkSize = m_compressor->chunkSize();
+
+    point_count_t numPts = m_chunkBuf.size() / pointLen;
+    point_count_t numChunks = numPts / chunkSize;
+    if (flush && (numPts % chunkSize))
+        numChunks++;
+    else
+        numPts = numChunks * chunkSize;
+
+    std::vector<std::string> chunks(numChunks);
+    for (point_count_t c = 0; c < numChunks; ++c)
+    {
+        const char *pos = m_chunkBuf.data() + c * chunkSize * pointLen;
+        point_count_t count = std::min(chunkSize, numPts - c * chunkSize);
+        std::string& chunk = chunks[c];
+        m_pool->add([this, &chunk, pos, count, pointLen]()
+            { chunk = m_compressor->compressChunk(pos, count, pointLen); });
+    }
+    m_pool->await();
+
+    for (const std::string& chunk : chunks)
+        m_compressor->writeChunk(chunk);
+    m_chunkBuf.erase(m_chunkBuf.begin(),
+        m_chunkBuf.begin() + numPts * pointLen);
+#endif
+}
+
+
 bool LasWriter::fillPointBuf(PointRef& point, LeInserter& ostream)
 {
     bool has14Format = m_lasHeader.has14Format();
@@ -929,6 +1012,11 @@ void LasWriter::finishLasZipOutput()
 void LasWriter::finishLazPerfOutput()
 {
 #ifdef PDAL_HAVE_LAZPERF
+    if (m_pool)
+    {
+        writeLazPerfChunks(true);
+        m_pool.reset();
+    }
     m_compressor->done();
 #endif
 }
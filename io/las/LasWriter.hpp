@@ -37,6 +37,7 @@
 #include <pdal/Compression.hpp>
 #include <pdal/FlexWriter.hpp>
 #include <pdal/plugin.hpp>
+#include <pdal/util/ThreadPool.hpp>
 
 #include "HeaderVal.hpp"
 #include "LasError.hpp"
@@ -86,6 +87,8 @@ private:
     std::unique_ptr<LASzipper> m_zipper;
     std::unique_ptr<ZipPoint> m_zipPoint;
     std::unique_ptr<LazPerfVlrCompressor> m_compressor;
+    std::unique_ptr<ThreadPool> m_pool;
+    std::vector<char> m_chunkBuf;
     bool m_discardHighReturnNumbers;
     std::map<std::string, std::string> m_headerVals;
     std::vector<VlrOptionInfo> m_optionInfos;
@@ -133,7 +136,11 @@ private:
     virtual void readyFile(const std::string& filename,
         const SpatialReference& srs);
     virtual void writeView(const PointViewPtr view);
+    virtual bool streamable() const
+        { return true; }
     virtual bool processOne(PointRef& point);
+    virtual point_count_t processBatch(StreamPointTable& table,
+        point_count_t count, SkipMask& skips);
     virtual void doneFile();
 
     void fillForwardList();
@@ -147,6 +154,7 @@ private:
         std::vector<char>& buf);
     void writeLasZipBuf(char *data, size_t pointLen, point_count_t numPts);
     void writeLazPerfBuf(char *data, size_t pointLen, point_count_t numPts);
+    void writeLazPerfChunks(bool flush);
     void setVlrsFromMetadata(MetadataNode& forward);
     MetadataNode findVlrMetadata(MetadataNode node, uint16_t recordId,
         const std::string& userId);
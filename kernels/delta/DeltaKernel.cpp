@@ -125,9 +125,13 @@ int DeltaKernel::execute()
             ++di;
     }
 
+    // Every source point is compared with its nearest candidate point.
+    if (candView->empty())
+        throw pdal_error("Candidate file '" + m_candidateFile +
+            "' has no points.");
+
     // Index the candidate data.
-    KD3Index index(*candView);
-    index.build();
+    KD3Index& index = candView->build3dIndex(threads());
 
     MetadataNode root;
 
@@ -146,13 +150,10 @@ MetadataNode DeltaKernel::dump(PointViewPtr& srcView, PointViewPtr& candView,
 {
     MetadataNode root;
 
+    NeighborTable nearest = index.knn(*srcView, 1, threads());
     for (PointId id = 0; id < srcView->size(); ++id)
     {
-        double x = srcView->getFieldAs<double>(Dimension::Id::X, id);
-        double y = srcView->getFieldAs<double>(Dimension::Id::Y, id);
-        double z = srcView->getFieldAs<double>(Dimension::Id::Z, id);
-
-        PointId candId = index.neighbor(x, y, z);
+        PointId candId = nearest.ids[id];
 
         // It may be faster to put in a special case to avoid having to
         // fetch X, Y and Z, more than once but this is simpler and
@@ -195,12 +196,10 @@ MetadataNode DeltaKernel::dumpDetail(PointViewPtr& srcView,
 {
     MetadataNode root;
 
+    NeighborTable nearest = index.knn(*srcView, 1, threads());
     for (PointId id = 0; id < srcView->size(); ++id)
     {
-        double x = srcView->getFieldAs<double>(Dimension::Id::X, id);
-        double y = srcView->getFieldAs<double>(Dimension::Id::Y, id);
-        double z = srcView->getFieldAs<double>(Dimension::Id::Z, id);
-        PointId candId = index.neighbor(x, y, z);
+        PointId candId = nearest.ids[id];
 
         MetadataNode delta = root.add("delta");
         delta.add("i", id);
@@ -314,7 +314,19 @@ MetadataNode InfoKernel::run(const std::string& filename)
     }
     else
     {
-        if (m_needPoints || m_showMetadata)
+        // Stream the points through the pipeline when the output doesn't
+        // need them held in memory, so that large files can be summarized.
+        bool stream = m_reader && m_pointIndexes.empty() &&
+            m_queryPoint.empty() && !m_showSchema &&
+            m_PointCloudSchemaOutput.empty() &&
+            m_manager.getStage()->pipelineStreamable();
+
+        if ((m_needPoints || m_showMetadata) && stream)
+        {
+            FixedPointTable table(10000);
+            m_manager.execute(table);
+        }
+        else if (m_needPoints || m_showMetadata)
             m_manager.execute();
         else
             m_manager.prepare();
@@ -378,11 +390,7 @@ void InfoKernel::dump(MetadataNode& root)
     }
 
     if (m_boundary)
-    {
-        PointViewSet viewSet = m_manager.views();
-        assert(viewSet.size() == 1);
         root.add(m_hexbinStage->getMetadata().clone("boundary"));
-    }
 }
 
 
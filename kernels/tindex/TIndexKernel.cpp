@@ -40,6 +40,7 @@
 #endif
 
 #include <memory>
+#include <set>
 #include <vector>
 
 #include <pdal/KernelFactory.hpp>
@@ -48,6 +49,7 @@
 #include <pdal/PDALUtils.hpp>
 #include <pdal/StageFactory.hpp>
 #include <pdal/pdal_macros.hpp>
+#include <pdal/util/ThreadPool.hpp>
 
 #include <cpl_string.h>
 
@@ -62,6 +64,36 @@ void setDate(OGRFeatureH feature, const tm& tyme, int fieldNumber)
 }
 
 
+tm getDate(OGRFeatureH feature, int fieldNumber)
+{
+    tm tyme = tm();
+    int year, month, day, hour, minute, second, tz;
+
+    if (fieldNumber >= 0 &&
+        OGR_F_GetFieldAsDateTime(feature, fieldNumber, &year, &month, &day,
+            &hour, &minute, &second, &tz))
+    {
+        tyme.tm_year = year - 1900;
+        tyme.tm_mon = month - 1;
+        tyme.tm_mday = day;
+        tyme.tm_hour = hour;
+        tyme.tm_min = minute;
+        tyme.tm_sec = second;
+    }
+    return tyme;
+}
+
+
+bool sameDate(const tm& t1, const tm& t2, bool datesOnly)
+{
+    if (t1.tm_year != t2.tm_year || t1.tm_mon != t2.tm_mon ||
+        t1.tm_mday != t2.tm_mday)
+        return false;
+    return datesOnly || (t1.tm_hour == t2.tm_hour &&
+        t1.tm_min == t2.tm_min && t1.tm_sec == t2.tm_sec);
+}
+
+
 } // anonymous namespace
 
 
@@ -85,6 +117,7 @@ TIndexKernel::TIndexKernel()
     , m_dataset(NULL)
     , m_layer(NULL)
     , m_fastBoundary(false)
+    , m_datesOnly(false)
 
 {}
 
@@ -212,30 +245,57 @@ StringList readSTDIN()
 }
 
 
-bool TIndexKernel::isFileIndexed(const FieldIndexes& indexes,
-    const FileInfo& fileInfo)
+// Read the names and times of the files already in the index.
+void TIndexKernel::readIndexedFiles(const FieldIndexes& indexes)
 {
-    std::ostringstream qstring;
+    // Some drivers (notably shapefile) only store the date of a date-time
+    // field.
+    void *fDefn = OGR_L_GetLayerDefn(m_layer);
+    m_datesOnly = (indexes.m_mtime >= 0 && OGR_Fld_GetType(
+        OGR_FD_GetFieldDefn(fDefn, indexes.m_mtime)) == OFTDate);
 
-    qstring << Utils::toupper(m_tileIndexColumnName) << "=" <<
-        "'" << fileInfo.m_filename << "'";
-    std::string query = qstring.str();
-    OGRErr err = OGR_L_SetAttributeFilter(m_layer, query.c_str());
-    if (err != OGRERR_NONE)
+    m_indexedFiles.clear();
+    OGR_L_ResetReading(m_layer);
+    while (true)
     {
-        std::ostringstream oss;
-        oss << "Unable to set attribute filter for file '" <<
-             fileInfo.m_filename << "'";
-        throw pdal_error(oss.str());
-    }
+        OGRFeatureH feature = OGR_L_GetNextFeature(m_layer);
+        if (!feature)
+            break;
 
-    bool output(false);
-    OGR_L_ResetReading(m_layer);
-    if (OGR_L_GetNextFeature(m_layer))
-        output = true;
+        std::string filename =
+            OGR_F_GetFieldAsString(feature, indexes.m_filename);
+        auto it = m_indexedFiles.find(filename);
+        if (it == m_indexedFiles.end())
+        {
+            IndexedFile& file = m_indexedFiles[filename];
+            file.m_ctime = getDate(feature, indexes.m_ctime);
+            file.m_mtime = getDate(feature, indexes.m_mtime);
+            it = m_indexedFiles.find(filename);
+        }
+        it->second.m_fids.push_back(OGR_F_GetFID(feature));
+
+        OGR_F_Destroy(feature);
+    }
     OGR_L_ResetReading(m_layer);
-    OGR_L_SetAttributeFilter(m_layer, NULL);
-    return output;
+}
+
+
+// A file is indexed if it's in the index and hasn't been created or
+// modified since.
+bool TIndexKernel::isFileIndexed(const FieldIndexes& indexes,
+    const FileInfo& fileInfo)
+{
+    auto it = m_indexedFiles.find(fileInfo.m_filename);
+    if (it == m_indexedFiles.end())
+        return false;
+
+    // Without stored times we can't tell whether the file has changed.
+    if (indexes.m_ctime < 0 || indexes.m_mtime < 0)
+        return true;
+
+    const IndexedFile& file = it->second;
+    return sameDate(file.m_ctime, fileInfo.m_ctime, m_datesOnly) &&
+        sameDate(file.m_mtime, fileInfo.m_mtime, m_datesOnly);
 }
 
 
@@ -279,27 +339,93 @@ void TIndexKernel::createFile()
         }
 
     FieldIndexes indexes = getFields();
-
-    KernelFactory factory(false);
+    readIndexedFiles(indexes);
+
+    // Files are read on the pool in batches.  The features of each batch
+    // are written once it completes, which limits the number of
+    // boundaries held in memory.
+    ThreadPool pool(threads());
+    const size_t batchSize = pool.numThreads() * 16;
+    std::vector<FileInfo> batch;
+    std::set<std::string> seen;
     for (auto f : m_files)
     {
         //ABELL - Not sure why we need to get absolute path here.
-        f = FileUtils::toAbsolutePath(f);
-        FileInfo info = getFileInfo(factory, f);
-        if (!isFileIndexed(indexes, info))
+        FileInfo info;
+        info.m_filename = FileUtils::toAbsolutePath(f);
+        if (!seen.insert(info.m_filename).second)
+            continue;
+        FileUtils::fileTimes(info.m_filename, &info.m_ctime, &info.m_mtime);
+        if (isFileIndexed(indexes, info))
         {
-            if (createFeature(indexes, info))
-                m_log->get(LogLevel::Info) << "Indexed file " << f << std::endl;
-            else
-                m_log->get(LogLevel::Error) << "Failed to create feature for "
-                    "file '" << f << "'" << std::endl;
-
+            m_log->get(LogLevel::Debug) << "Skipped unchanged file " <<
+                info.m_filename << std::endl;
+            continue;
+        }
+        batch.push_back(info);
+        if (batch.size() == batchSize)
+        {
+            indexFiles(pool, indexes, batch);
+            batch.clear();
         }
     }
+    indexFiles(pool, indexes, batch);
     OGR_DS_Destroy(m_dataset);
 }
 
 
+void TIndexKernel::indexFiles(ThreadPool& pool, const FieldIndexes& indexes,
+    std::vector<FileInfo>& files)
+{
+    // A file that can't be read is logged and skipped rather than ending
+    // the run.  Errors are logged once the batch completes.
+    std::vector<std::string> errors(files.size());
+    for (size_t i = 0; i < files.size(); ++i)
+        pool.add([this, &files, &errors, i]()
+        {
+            try
+            {
+                getFileInfo(files[i]);
+            }
+            catch (const std::exception& err)
+            {
+                errors[i] = err.what();
+                if (errors[i].empty())
+                    errors[i] = "unknown error";
+            }
+        });
+    pool.await();
+
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        FileInfo& info = files[i];
+        if (errors[i].size())
+        {
+            m_log->get(LogLevel::Error) << "Unable to index file '" <<
+                info.m_filename << "': " << errors[i] << std::endl;
+            continue;
+        }
+
+        // Replace the features of a file that has changed since it was
+        // indexed.
+        auto it = m_indexedFiles.find(info.m_filename);
+        if (it != m_indexedFiles.end())
+        {
+            for (int64_t fid : it->second.m_fids)
+                OGR_L_DeleteFeature(m_layer, fid);
+            m_indexedFiles.erase(it);
+        }
+
+        if (createFeature(indexes, info))
+            m_log->get(LogLevel::Info) << "Indexed file " <<
+                info.m_filename << std::endl;
+        else
+            m_log->get(LogLevel::Error) << "Failed to create feature for "
+                "file '" << info.m_filename << "'" << std::endl;
+    }
+}
+
+
 void TIndexKernel::mergeFile()
 {
     using namespace gdal;
@@ -481,17 +607,19 @@ bool TIndexKernel::createFeature(const FieldIndexes& indexes,
 }
 
 
-TIndexKernel::FileInfo TIndexKernel::getFileInfo(KernelFactory& factory,
-    const std::string& filename)
+// Find the boundary and SRS of a file.  This is called for several files
+// at once on the kernel's threads.
+void TIndexKernel::getFileInfo(FileInfo& fileInfo)
 {
-    FileInfo fileInfo;
-
     PipelineManager manager;
     manager.commonOptions() = m_manager.commonOptions();
     manager.stageOptions() = m_manager.stageOptions();
+    // Files are already being read concurrently.
+    if (threads() != 1)
+        manager.commonOptions().replace("threads", 1);
 
     // Need to make sure options get set.
-    Stage& reader = manager.makeReader(filename, "");
+    Stage& reader = manager.makeReader(fileInfo.m_filename, "");
 
     if (m_fastBoundary)
     {
@@ -509,28 +637,40 @@ TIndexKernel::FileInfo TIndexKernel::getFileInfo(KernelFactory& factory,
         fileInfo.m_boundary = polygon.str();
         if (!qi.m_srs.empty())
             fileInfo.m_srs = qi.m_srs.getWKT();
+        return;
     }
-    else
-    {
-        Stage& hexer = manager.makeFilter("filters.hexbin", reader);
 
-        PointTable table;
+    Stage& hexer = manager.makeFilter("filters.hexbin", reader);
+
+    // Stream the points through the hexbin filter when possible so that
+    // memory use doesn't grow with the size of the file.
+    if (hexer.pipelineStreamable())
+    {
+        FixedPointTable table(10000);
         hexer.prepare(table);
-        PointViewSet set = hexer.execute(table);
+        hexer.execute(table);
 
         MetadataNode m = table.metadata();
         m = m.findChild("filters.hexbin:boundary");
         fileInfo.m_boundary = m.value();
 
-        PointViewPtr v = *set.begin();
-        if (!v->spatialReference().empty())
-            fileInfo.m_srs = v->spatialReference().getWKT();
+        SpatialReference srs = table.anySpatialReference();
+        if (!srs.empty())
+            fileInfo.m_srs = srs.getWKT();
+        return;
     }
 
-    FileUtils::fileTimes(filename, &fileInfo.m_ctime, &fileInfo.m_mtime);
-    fileInfo.m_filename = filename;
+    PointTable table;
+    hexer.prepare(table);
+    PointViewSet set = hexer.execute(table);
+
+    MetadataNode m = table.metadata();
+    m = m.findChild("filters.hexbin:boundary");
+    fileInfo.m_boundary = m.value();
 
-    return fileInfo;
+    PointViewPtr v = *set.begin();
+    if (!v->spatialReference().empty())
+        fileInfo.m_srs = v->spatialReference().getWKT();
 }
 
 
@@ -40,6 +40,9 @@
 #include <pdal/util/FileUtils.hpp>
 #include <pdal/plugin.hpp>
 
+#include <map>
+#include <vector>
+
 
 extern "C" int32_t TIndexKernel_ExitFunc();
 extern "C" PF_ExitFunc TIndexKernel_InitPlugin();
@@ -48,6 +51,7 @@ namespace pdal
 {
 
 class KernelFactory;
+class ThreadPool;
 
 class PDAL_DLL TIndexKernel : public Kernel
 {
@@ -68,6 +72,15 @@ class PDAL_DLL TIndexKernel : public Kernel
         int m_mtime;
     };
 
+    // Entry for a file already in the index.  A file may have been indexed
+    // more than once, so it may have several features.
+    struct IndexedFile
+    {
+        std::vector<int64_t> m_fids;
+        struct tm m_ctime;
+        struct tm m_mtime;
+    };
+
 public:
     static void * create();
     static int32_t destroy(void *);
@@ -87,14 +100,17 @@ private:
     bool openLayer(const std::string& layerName);
     bool createLayer(const std::string& layerName);
     FieldIndexes getFields();
-    FileInfo getFileInfo(KernelFactory& factory, const std::string& filename);
+    void getFileInfo(FileInfo& fileInfo);
     bool createFeature(const FieldIndexes& indexes, FileInfo& info);
     gdal::Geometry prepareGeometry(const FileInfo& fileInfo);
     gdal::Geometry prepareGeometry(const std::string& wkt,
         const gdal::SpatialRef& inSrs, const gdal::SpatialRef& outSrs);
     void createFields();
 
-    bool isFileIndexed( const FieldIndexes& indexes, const FileInfo& fileInfo);
+    void readIndexedFiles(const FieldIndexes& indexes);
+    bool isFileIndexed(const FieldIndexes& indexes, const FileInfo& fileInfo);
+    void indexFiles(ThreadPool& pool, const FieldIndexes& indexes,
+        std::vector<FileInfo>& files);
 
     std::string m_idxFilename;
     std::string m_filespec;
@@ -114,6 +130,8 @@ private:
     std::string m_assignSrsString;
     bool m_fastBoundary;
     bool m_usestdin;
+    std::map<std::string, IndexedFile> m_indexedFiles;
+    bool m_datesOnly;
 };
 
 } // namespace pdal
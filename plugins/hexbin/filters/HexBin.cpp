@@ -80,15 +80,28 @@ void HexBin::ready(PointTableRef table)
 }
 
 
+// The grid keeps a fixed-size sample of the first points to estimate the
+// hexagon size when no edge length is given, and then only counts points
+// by cell, so streaming points through the filter uses memory bounded by
+// the number of occupied cells rather than the number of points.
+bool HexBin::processOne(PointRef& point)
+{
+    double x = point.getFieldAs<double>(pdal::Dimension::Id::X);
+    double y = point.getFieldAs<double>(pdal::Dimension::Id::Y);
+    m_grid->addPoint(x, y);
+    m_count++;
+    return true;
+}
+
+
 void HexBin::filter(PointView& view)
 {
+    PointRef point(view, 0);
     for (PointId idx = 0; idx < view.size(); ++idx)
     {
-        double x = view.getFieldAs<double>(pdal::Dimension::Id::X, idx);
-        double y = view.getFieldAs<double>(pdal::Dimension::Id::Y, idx);
-        m_grid->addPoint(x, y);
+        point.setPointId(idx);
+        processOne(point);
     }
-    m_count += view.size();
 }
 
 
@@ -71,6 +71,9 @@ private:
 
     virtual void addArgs(ProgramArgs& args);
     virtual void ready(PointTableRef table);
+    virtual bool streamable() const
+        { return true; }
+    virtual bool processOne(PointRef& point);
     virtual void filter(PointView& view);
     virtual void done(PointTableRef table);
 
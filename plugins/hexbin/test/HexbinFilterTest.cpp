@@ -92,3 +92,44 @@ TEST(HexbinFilterTest, HexbinFilterTest_test_1)
     out.close();
     FileUtils::deleteFile(filename);
 }
+
+// The boundary found by streaming points must match the one found from a
+// point view.
+TEST(HexbinFilterTest, stream)
+{
+    auto boundary = [](bool stream)
+    {
+        StageFactory f;
+
+        Options options;
+        options.add("filename", Support::datapath("las/hextest.las"));
+        Stage* reader(f.createStage("readers.las"));
+        reader->setOptions(options);
+
+        Stage* hexbin(f.createStage("filters.hexbin"));
+        Options hexOptions;
+        hexOptions.add("sample_size", 100);
+        hexOptions.add("threshold", 1);
+        hexbin->setOptions(hexOptions);
+        hexbin->setInput(*reader);
+        EXPECT_TRUE(hexbin->pipelineStreamable());
+
+        if (stream)
+        {
+            FixedPointTable table(50);
+            hexbin->prepare(table);
+            hexbin->execute(table);
+        }
+        else
+        {
+            PointTable table;
+            hexbin->prepare(table);
+            hexbin->execute(table);
+        }
+        return hexbin->getMetadata().findChild("boundary").value();
+    };
+
+    std::string b = boundary(false);
+    EXPECT_FALSE(b.empty());
+    EXPECT_EQ(boundary(true), b);
+}
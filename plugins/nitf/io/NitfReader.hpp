@@ -89,12 +89,10 @@ public:
     std::string getName() const;
 
 protected:
-    virtual void createStream()
-    {
-        if (m_streamIf)
-            std::cerr << "Attempt to create stream twice!\n";
-        m_streamIf.reset(new NitfStreamIf(m_filename, m_offset, m_length));
-    }
+    virtual LasStreamIf *openStream()
+        { return new NitfStreamIf(m_filename, m_offset, m_length); }
+    virtual uint64_t fileOffset() const
+        { return m_offset; }
 
 private:
     uint64_t m_offset;
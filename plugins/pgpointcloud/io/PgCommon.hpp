@@ -52,7 +52,7 @@ inline pdal::CompressionType getCompressionType(
         return CompressionType::Dimensional;
     else if (compression_type == "ght")
         return CompressionType::Ght;
-    else if (compression_type == "laszperf")
+    else if (compression_type == "lazperf" || compression_type == "laszperf")
         return CompressionType::Lazperf;
     return CompressionType::None;
 }
@@ -108,6 +108,42 @@ inline void pg_commit(PGconn* session)
     pg_execute(session, sql);
 }
 
+inline void pg_copy_start(PGconn* session, std::string const& sql)
+{
+    PGresult *result = PQexec(session, sql.c_str());
+    if ( (!result) || (PQresultStatus(result) != PGRES_COPY_IN) )
+    {
+        std::string errmsg = std::string(PQerrorMessage(session));
+        PQclear(result);
+        throw pdal_error(errmsg);
+    }
+    PQclear(result);
+}
+
+inline void pg_copy_data(PGconn* session, const char *data, size_t size)
+{
+    if ( PQputCopyData(session, data, (int)size) != 1 )
+        throw pdal_error(PQerrorMessage(session));
+}
+
+inline void pg_copy_end(PGconn* session)
+{
+    if ( PQputCopyEnd(session, NULL) != 1 )
+        throw pdal_error(PQerrorMessage(session));
+
+    // Errors in the copied data are only reported once the copy ends.
+    std::string errmsg;
+    PGresult *result;
+    while ( (result = PQgetResult(session)) )
+    {
+        if ( PQresultStatus(result) != PGRES_COMMAND_OK && errmsg.empty() )
+            errmsg = std::string(PQresultErrorMessage(result));
+        PQclear(result);
+    }
+    if ( errmsg.size() )
+        throw pdal_error(errmsg);
+}
+
 inline char* pg_query_once(PGconn* session, std::string const& sql)
 {
     PGresult *result = PQexec(session, sql.c_str());
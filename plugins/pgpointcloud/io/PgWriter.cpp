@@ -43,6 +43,8 @@
 #include <pdal/util/portable_endian.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 
+#include <cstring>
+
 namespace pdal
 {
 
@@ -56,8 +58,6 @@ CREATE_SHARED_PLUGIN(1, 0, PgWriter, Writer, s_info)
 std::string PgWriter::getName() const { return s_info.name; }
 
 // TO DO:
-// - change INSERT into COPY
-//
 // - PCID / Schema consistency. If a PCID is specified,
 // must it be consistent with the buffer schema? Or should
 // the writer shove the data into the database schema as best
@@ -73,12 +73,16 @@ PgWriter::PgWriter()
     , m_srid(0)
     , m_pcid(0)
     , m_overwrite(true)
+    , m_parallelConnections(false)
     , m_schema_is_initialized(false)
 {}
 
 
 PgWriter::~PgWriter()
 {
+    for (PGconn* session : m_copySessions)
+        if (session != m_session)
+            PQfinish(session);
     if (m_session)
         PQfinish(m_session);
 }
@@ -99,6 +103,9 @@ void PgWriter::addArgs(ProgramArgs& args)
     args.add("pcid", "PCID", m_pcid);
     args.add("pre_sql", "SQL to execute before query", m_pre_sql);
     args.add("post_sql", "SQL to execute after query", m_post_sql);
+    args.add("parallel_connections", "Write views concurrently, each on "
+        "its own connection and in its own transaction",
+        m_parallelConnections);
 }
 
 
@@ -111,6 +118,7 @@ void PgWriter::initialize()
 
 void PgWriter::writeInit()
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     if (m_schema_is_initialized)
         return;
 
@@ -150,6 +158,18 @@ void PgWriter::writeInit()
         CreateTable(m_schema_name, m_table_name, m_column_name, m_pcid);
     }
 
+    // Views written on other connections can only see the table once it
+    // has been committed.
+    if (m_parallelConnections)
+    {
+        pg_commit(m_session);
+        pg_begin(m_session);
+    }
+
+    m_dbDimTypes.clear();
+    for (auto& dim : dbDimTypes())
+        m_dbDimTypes.push_back(dim.m_dimType);
+
     m_schema_is_initialized = true;
 }
 
@@ -162,6 +182,24 @@ void PgWriter::write(const PointViewPtr view)
 
 void PgWriter::done(PointTableRef /*table*/)
 {
+    // Finish all the copies before committing anything, so that a copy
+    // that fails leaves the patches on every connection uncommitted.
+    for (PGconn* session : m_copySessions)
+        pg_copy_end(session);
+
+    // Connections other than the main session hold their own transactions.
+    while (m_copySessions.size())
+    {
+        PGconn* session = m_copySessions.back();
+        if (session != m_session)
+        {
+            pg_commit(session);
+            PQfinish(session);
+        }
+        m_copySessions.pop_back();
+    }
+    m_idleSessions.clear();
+
     //CreateIndex(m_schema_name, m_table_name, m_column_name);
 
     if (m_post_sql.size())
@@ -227,6 +265,8 @@ uint32_t PgWriter::SetupSchema(uint32_t srid)
         compression = "dimensional";
     else if (m_patch_compression_type == CompressionType::Ght)
         compression = "ght";
+    else if (m_patch_compression_type == CompressionType::Lazperf)
+        compression = "lazperf";
 
     Metadata metadata;
     MetadataNode m = metadata.getNode();
@@ -418,71 +458,125 @@ void PgWriter::CreateIndex(std::string const& schema_name,
 }
 
 
-void PgWriter::writeTile(const PointViewPtr view)
+// Get a connection on which to copy a patch.  Patches are normally copied
+// on the main session, inside the transaction that created the table.
+// With parallel_connections, each view being written gets a connection
+// of its own.
+PGconn* PgWriter::acquireSession()
 {
-    std::vector<char> storage(packedPointSize());
-    std::string hexrep;
-    size_t maxHexrepSize = packedPointSize() * view->size() * 2;
-    hexrep.reserve(maxHexrepSize);
-
-    m_insert.clear();
-    m_insert.reserve(maxHexrepSize + 3000);
+    std::lock_guard<std::mutex> lock(m_mutex);
 
-    for (PointId idx = 0; idx < view->size(); ++idx)
+    if (m_idleSessions.size())
     {
-        size_t size = readPoint(*view.get(), idx, storage.data());
+        PGconn* session = m_idleSessions.back();
+        m_idleSessions.pop_back();
+        return session;
+    }
 
-        /* We are always getting uncompressed bytes off the block_data */
-        /* so we always used compression type 0 (uncompressed) in writing */
-        /* our WKB */
-        static char syms[] = "0123456789ABCDEF";
-        for (size_t i = 0; i != size; i++)
-        {
-            hexrep.push_back(syms[((storage[i] >> 4) & 0xf)]);
-            hexrep.push_back(syms[storage[i] & 0xf]);
-        }
+    PGconn* session = m_session;
+    if (m_parallelConnections)
+    {
+        session = pg_connect(m_connection);
+        m_copySessions.push_back(session);
+        pg_begin(session);
     }
+    else
+        m_copySessions.push_back(session);
+
+    std::ostringstream oss;
+    oss << "COPY ";
+    if (m_schema_name.size())
+        oss << pg_quote_identifier(m_schema_name) << ".";
+    oss << pg_quote_identifier(m_table_name) << " (" <<
+        pg_quote_identifier(m_column_name) << ") FROM STDIN";
+    pg_copy_start(session, oss.str());
 
-    std::string insert_into("INSERT INTO ");
-    std::string values(" (" + pg_quote_identifier(m_column_name) +
-                       ") VALUES ('");
+    return session;
+}
 
-    m_insert.append(insert_into);
 
-    if (m_schema_name.size())
-    {
-        m_insert.append(pg_quote_identifier(m_schema_name));
-        m_insert.append(".");
-    }
+void PgWriter::releaseSession(PGconn* session)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_idleSessions.push_back(session);
+}
 
-    m_insert.append(pg_quote_identifier(m_table_name));
-    m_insert.append(values);
 
-    std::ostringstream options;
+// Build the WKB of a patch holding the points of a view.
+std::vector<char> PgWriter::patchWkb(const PointView& view)
+{
+    std::vector<char> wkb;
 
-    uint32_t num_points = htobe32(view->size());
-    int32_t pcid = htobe32(m_pcid);
-    CompressionType compression_v = CompressionType::None;
-    uint32_t compression = htobe32(static_cast<uint32_t>(compression_v));
+    auto putUint32 = [&wkb](uint32_t v)
+    {
+        char buf[sizeof(v)];
+        memcpy(buf, &v, sizeof(v));
+        wkb.insert(wkb.end(), buf, buf + sizeof(v));
+    };
+
+    std::vector<char> points(packedPointSize() * view.size());
+    size_t pos = 0;
+    for (PointId idx = 0; idx < view.size(); ++idx)
+        pos += readPoint(view, idx, points.data() + pos);
+    points.resize(pos);
+
+    CompressionType compression = CompressionType::None;
+#ifdef PDAL_HAVE_LAZPERF
+    if (m_patch_compression_type == CompressionType::Lazperf)
+        compression = CompressionType::Lazperf;
+#endif
 
+    // The header values are in the byte order of this machine, which is
+    // given by the first byte.
 #if BYTE_ORDER == LITTLE_ENDIAN
-    options << "01";
+    wkb.push_back(1);
 #elif BYTE_ORDER == BIG_ENDIAN
-    options << "00";
+    wkb.push_back(0);
 #endif
+    putUint32(m_pcid);
+    putUint32(static_cast<uint32_t>(compression));
+    putUint32(static_cast<uint32_t>(view.size()));
+
+#ifdef PDAL_HAVE_LAZPERF
+    if (compression == CompressionType::Lazperf)
+    {
+        std::vector<char> compressed;
+        SignedLazPerfBuf buf(compressed);
+        LazPerfCompressor<SignedLazPerfBuf> compressor(buf, m_dbDimTypes);
+        compressor.compress(points.data(), points.size());
+        compressor.done();
+
+        putUint32(static_cast<uint32_t>(compressed.size()));
+        wkb.insert(wkb.end(), compressed.begin(), compressed.end());
+        return wkb;
+    }
+#endif
+
+    // Uncompressed patches are compressed by the database as set in
+    // the schema.
+    wkb.insert(wkb.end(), points.begin(), points.end());
+    return wkb;
+}
 
-    // needs to be 4 bytes
-    options << std::hex << std::setfill('0') << std::setw(8) << pcid;
-    // needs to be 4 bytes
-    options << std::hex << std::setfill('0') << std::setw(8) << compression;
-    // needs to be 4 bytes
-    options << std::hex << std::setfill('0') << std::setw(8) << num_points;
 
-    m_insert.append(options.str());
-    m_insert.append(hexrep);
-    m_insert.append("')");
+void PgWriter::writeTile(const PointViewPtr view)
+{
+    std::vector<char> wkb = patchWkb(*view);
+
+    // Each row of the copy is the hex WKB of a patch.
+    static const char syms[] = "0123456789ABCDEF";
+    std::vector<char> row(wkb.size() * 2 + 1);
+    char *out = row.data();
+    for (char c : wkb)
+    {
+        *out++ = syms[(c >> 4) & 0xf];
+        *out++ = syms[c & 0xf];
+    }
+    *out = '\n';
 
-    pg_execute(m_session, m_insert);
+    PGconn* session = acquireSession();
+    pg_copy_data(session, row.data(), row.size());
+    releaseSession(session);
 }
 
 } // namespace pdal
@@ -39,6 +39,9 @@
 #include <pdal/StageFactory.hpp>
 #include "PgCommon.hpp"
 
+#include <mutex>
+#include <vector>
+
 namespace pdal
 {
 
@@ -59,10 +62,15 @@ private:
     virtual void addArgs(ProgramArgs& args);
     virtual void initialize();
     virtual void write(const PointViewPtr view);
+    virtual bool parallelSafe() const
+        { return m_parallelConnections; }
     virtual void done(PointTableRef table);
 
     void writeInit();
     void writeTile(const PointViewPtr view);
+    std::vector<char> patchWkb(const PointView& view);
+    PGconn* acquireSession();
+    void releaseSession(PGconn* session);
 
     bool CheckTableExists(std::string const& name);
     bool CheckPointCloudExists();
@@ -95,13 +103,21 @@ private:
     uint32_t m_srid;
     uint32_t m_pcid;
     bool m_overwrite;
-    std::string m_insert;
+    DimTypeList m_dbDimTypes;
     Orientation m_orientation;
     std::string m_pre_sql;
     std::string m_post_sql;
+    bool m_parallelConnections;
 
     // lose this
     bool m_schema_is_initialized;
+
+    // Views may be written concurrently, each on its own connection.
+    // Connections in m_copySessions have a COPY in progress and those not
+    // in use by a view are in m_idleSessions.
+    std::mutex m_mutex;
+    std::vector<PGconn*> m_copySessions;
+    std::vector<PGconn*> m_idleSessions;
 };
 
 } // namespace pdal
@@ -34,6 +34,10 @@
 
 #include <pdal/pdal_test_main.hpp>
 
+#include <algorithm>
+#include <array>
+#include <vector>
+
 #include <pdal/Writer.hpp>
 #include <pdal/StageFactory.hpp>
 #include <pdal/util/Algorithm.hpp>
@@ -287,3 +291,68 @@ TEST_F(PgpointcloudWriterTest, writetNoPointcloudExtension)
 
     EXPECT_THROW(writer->execute(table), pdal_error);
 }
+
+TEST_F(PgpointcloudWriterTest, writeParallel)
+{
+    if (shouldSkipTests())
+    {
+        return;
+    }
+
+    // Write the chipped file and read back the coordinates of the points
+    // in the table.  Patches written on several connections arrive in no
+    // particular order, so the points are sorted.
+    auto writeAndRead = [](bool parallel)
+    {
+        StageFactory f;
+        Stage* reader(f.createStage("readers.las"));
+        Options options;
+        options.add("filename",
+            Support::datapath("las/1.2-with-color.las"));
+        reader->setOptions(options);
+
+        Stage* chipper(f.createStage("filters.chipper"));
+        Options chipperOps;
+        chipperOps.add("capacity", 100);
+        chipper->setOptions(chipperOps);
+        chipper->setInput(*reader);
+
+        Stage* writer(f.createStage("writers.pgpointcloud"));
+        Options writerOps = getDbOptions();
+        writerOps.add("threads", 4);
+        writerOps.add("parallel_connections", parallel);
+        writer->setOptions(writerOps);
+        writer->setInput(*chipper);
+
+        PointTable table;
+        writer->prepare(table);
+        PointViewSet written = writer->execute(table);
+        EXPECT_GT(written.size(), 1U);
+
+        PointTable readTable;
+        Stage* pgReader(f.createStage("readers.pgpointcloud"));
+        pgReader->setOptions(getDbOptions());
+        pgReader->prepare(readTable);
+        PointViewSet read = pgReader->execute(readTable);
+
+        std::vector<std::array<double, 3>> points;
+        for (auto i = read.begin(); i != read.end(); ++i)
+        {
+            PointViewPtr view = *i;
+            for (PointId idx = 0; idx < view->size(); ++idx)
+                points.push_back({{
+                    view->getFieldAs<double>(Dimension::Id::X, idx),
+                    view->getFieldAs<double>(Dimension::Id::Y, idx),
+                    view->getFieldAs<double>(Dimension::Id::Z, idx) }});
+        }
+        std::sort(points.begin(), points.end());
+        return points;
+    };
+
+    // Write the patches on one connection and then on several at once.
+    // The table is overwritten each time.
+    std::vector<std::array<double, 3>> serial = writeAndRead(false);
+    std::vector<std::array<double, 3>> parallel = writeAndRead(true);
+    EXPECT_EQ(serial.size(), 1065U);
+    EXPECT_EQ(serial, parallel);
+}
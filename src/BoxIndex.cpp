@@ -0,0 +1,159 @@
+/******************************************************************************
+* Copyright (c) 2016, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/BoxIndex.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace pdal
+{
+
+namespace
+{
+
+// Children of each node of the tree.
+const uint32_t Fanout = 16;
+
+// Order boxes so that each run of Fanout boxes is compact: sort by the X
+// of their centers, split into vertical slices and sort each slice by Y.
+std::vector<uint32_t> strOrder(const std::vector<BOX2D>& boxes)
+{
+    const std::size_t n = boxes.size();
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+
+    auto centerX = [&boxes](uint32_t i)
+        { return boxes[i].minx + boxes[i].maxx; };
+    auto centerY = [&boxes](uint32_t i)
+        { return boxes[i].miny + boxes[i].maxy; };
+
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+        { return centerX(a) < centerX(b); });
+
+    const std::size_t numNodes = (n + Fanout - 1) / Fanout;
+    const std::size_t numSlices =
+        (std::size_t)std::ceil(std::sqrt((double)numNodes));
+    const std::size_t sliceSize = numSlices * Fanout;
+    for (std::size_t start = 0; start < n; start += sliceSize)
+    {
+        auto end = order.begin() + (std::min)(start + sliceSize, n);
+        std::sort(order.begin() + start, end, [&](uint32_t a, uint32_t b)
+            { return centerY(a) < centerY(b); });
+    }
+    return order;
+}
+
+} // unnamed namespace
+
+
+BoxIndex::BoxIndex(const std::vector<BOX2D>& boxes) : m_boxes(boxes),
+    m_numLeaves(0)
+{
+    if (m_boxes.empty())
+        return;
+
+    // Pack the boxes into leaves.
+    m_items = strOrder(m_boxes);
+    for (uint32_t i = 0; i < m_items.size(); i += Fanout)
+    {
+        Node node;
+        node.m_first = i;
+        node.m_count = (std::min)(Fanout, (uint32_t)m_items.size() - i);
+        for (uint32_t j = i; j < i + node.m_count; ++j)
+            node.m_bounds.grow(m_boxes[m_items[j]]);
+        m_nodes.push_back(node);
+    }
+    m_numLeaves = m_nodes.size();
+
+    // Pack each level of nodes into the level above until one is left.
+    uint32_t levelStart = 0;
+    uint32_t levelEnd = m_nodes.size();
+    while (levelEnd - levelStart > 1)
+    {
+        std::vector<BOX2D> bounds;
+        for (uint32_t i = levelStart; i < levelEnd; ++i)
+            bounds.push_back(m_nodes[i].m_bounds);
+        std::vector<uint32_t> order = strOrder(bounds);
+
+        std::vector<Node> level;
+        for (uint32_t i : order)
+            level.push_back(m_nodes[levelStart + i]);
+        std::copy(level.begin(), level.end(), m_nodes.begin() + levelStart);
+
+        for (uint32_t i = levelStart; i < levelEnd; i += Fanout)
+        {
+            Node node;
+            node.m_first = i;
+            node.m_count = (std::min)(Fanout, levelEnd - i);
+            for (uint32_t j = i; j < i + node.m_count; ++j)
+                node.m_bounds.grow(m_nodes[j].m_bounds);
+            m_nodes.push_back(node);
+        }
+        levelStart = levelEnd;
+        levelEnd = m_nodes.size();
+    }
+}
+
+
+void BoxIndex::query(double x, double y, std::vector<uint32_t>& ids) const
+{
+    ids.clear();
+    if (m_nodes.size())
+        query(m_nodes.size() - 1, x, y, ids);
+}
+
+
+void BoxIndex::query(uint32_t node, double x, double y,
+    std::vector<uint32_t>& ids) const
+{
+    const Node& n = m_nodes[node];
+    if (!n.m_bounds.contains(x, y))
+        return;
+
+    if (node < m_numLeaves)
+    {
+        for (uint32_t i = n.m_first; i < n.m_first + n.m_count; ++i)
+            if (m_boxes[m_items[i]].contains(x, y))
+                ids.push_back(m_items[i]);
+    }
+    else
+    {
+        for (uint32_t i = n.m_first; i < n.m_first + n.m_count; ++i)
+            query(i, x, y, ids);
+    }
+}
+
+} // namespace pdal
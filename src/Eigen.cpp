@@ -33,17 +33,155 @@
 ****************************************************************************/
 
 #include <pdal/Eigen.hpp>
+#include <pdal/KDIndex.hpp>
 #include <pdal/PointView.hpp>
 #include <pdal/util/Bounds.hpp>
+#include <pdal/util/ThreadPool.hpp>
 
 #include <Eigen/Dense>
 
+#include <functional>
+#include <limits>
 #include <vector>
 
 namespace pdal
 {
 
-Eigen::Vector3f computeCentroid(PointView& view, std::vector<PointId> ids)
+namespace
+{
+
+// Find the extreme (minimum or maximum, as chosen by 'better') of each
+// window of 'n' values centered on each value of 'in', with windows
+// clipped to the ends of the input.  NaN values are skipped and a window
+// with no other values gets 'init'.
+//
+// This is the van Herk/Gil-Werman algorithm: the input, padded by half a
+// window on each side, is split into blocks one window long.  Each window
+// spans at most two blocks, so its extreme is the extreme of a suffix of
+// one block and a prefix of the next, both found in a single pass.
+template<typename BETTER>
+void runningExtreme(const double *in, int n, int halfWidth, double init,
+    BETTER better, double *out, std::vector<double>& prefix,
+    std::vector<double>& suffix)
+{
+    auto pick = [better](double cur, double v)
+        { return better(v, cur) ? v : cur; };
+
+    const int window = 2 * halfWidth + 1;
+    const int padded = n + 2 * halfWidth;
+    const int blocks = (padded + window - 1) / window;
+    const int size = blocks * window;
+    prefix.resize(size);
+    suffix.resize(size);
+
+    auto value = [in, n, halfWidth, init](int i)
+    {
+        i -= halfWidth;
+        return (i >= 0 && i < n) ? in[i] : init;
+    };
+
+    for (int start = 0; start < size; start += window)
+    {
+        const int end = start + window - 1;
+        prefix[start] = pick(init, value(start));
+        for (int i = start + 1; i <= end; ++i)
+            prefix[i] = pick(prefix[i - 1], value(i));
+        suffix[end] = pick(init, value(end));
+        for (int i = end - 1; i >= start; --i)
+            suffix[i] = pick(suffix[i + 1], value(i));
+    }
+
+    // The window of input value i is [i, i + 2 * halfWidth] in padded
+    // coordinates.
+    for (int i = 0; i < n; ++i)
+        out[i] = pick(suffix[i], prefix[i + window - 1]);
+}
+
+// Apply a disk-shaped minimum or maximum filter.  The disk is the union
+// of vertical segments, one for each column offset, so each result cell
+// is the extreme of the running extremes of the neighboring columns, with
+// segment lengths set by the column offset.  Columns are contiguous in
+// Eigen's default storage order.
+template<typename BETTER>
+Eigen::MatrixXd diskFilter(const Eigen::MatrixXd& data, int radius,
+    std::size_t threads, double init, BETTER better)
+{
+    using namespace Eigen;
+
+    const int rows = data.rows();
+    const int cols = data.cols();
+    MatrixXd out = MatrixXd::Constant(rows, cols, init);
+    if (rows == 0 || cols == 0)
+        return out;
+
+    // Half-height of the segment at each column offset.
+    std::vector<int> halfHeight(radius + 1);
+    for (int d = 0; d <= radius; ++d)
+    {
+        int h = 0;
+        while ((h + 1) * (h + 1) + d * d <= radius * radius)
+            h++;
+        halfHeight[d] = h;
+    }
+
+    // Each band of output columns reads the input columns within 'radius'
+    // of it.
+    ThreadPool pool(threads);
+    const int numBands = (std::min)(cols, (int)pool.numThreads() * 4);
+    for (int b = 0; b < numBands; ++b)
+    {
+        const int first = (int64_t)cols * b / numBands;
+        const int last = (int)((int64_t)cols * (b + 1) / numBands);
+        pool.add([&, first, last]()
+        {
+            std::vector<double> run(rows);
+            std::vector<double> prefix;
+            std::vector<double> suffix;
+            auto pick = [better](double cur, double v)
+                { return better(v, cur) ? v : cur; };
+            auto apply = [&](int c)
+            {
+                double *dst = out.data() + (std::size_t)c * rows;
+                for (int r = 0; r < rows; ++r)
+                    dst[r] = pick(dst[r], run[r]);
+            };
+
+            const int srcFirst = (std::max)(first - radius, 0);
+            const int srcLast = (std::min)(last + radius, cols);
+            for (int src = srcFirst; src < srcLast; ++src)
+            {
+                const double *col = data.data() + (std::size_t)src * rows;
+                int computed = -1;
+                for (int d = 0; d <= radius; ++d)
+                {
+                    const int left = src - d;
+                    const int right = src + d;
+                    const bool useLeft = left >= first && left < last;
+                    const bool useRight = d && right >= first && right < last;
+                    if (!useLeft && !useRight)
+                        continue;
+                    if (halfHeight[d] != computed)
+                    {
+                        computed = halfHeight[d];
+                        runningExtreme(col, rows, computed, init, better,
+                            run.data(), prefix, suffix);
+                    }
+                    if (useLeft)
+                        apply(left);
+                    if (useRight)
+                        apply(right);
+                }
+            }
+        });
+    }
+    pool.await();
+    return out;
+}
+
+} // unnamed namespace
+
+Eigen::Vector3f computeCentroid(PointView& view,
+    const std::vector<PointId>& ids)
 {
     using namespace Eigen;
 
@@ -64,7 +202,8 @@ Eigen::Vector3f computeCentroid(PointView& view, std::vector<PointId> ids)
     return centroid;
 }
 
-Eigen::Matrix3f computeCovariance(PointView& view, std::vector<PointId> ids)
+Eigen::Matrix3f computeCovariance(PointView& view,
+    const std::vector<PointId>& ids)
 {
     using namespace Eigen;
 
@@ -86,7 +225,8 @@ Eigen::Matrix3f computeCovariance(PointView& view, std::vector<PointId> ids)
     return A * A.transpose();
 }
 
-uint8_t computeRank(PointView& view, std::vector<PointId> ids, double threshold)
+uint8_t computeRank(PointView& view, const std::vector<PointId>& ids,
+    double threshold)
 {
     using namespace Eigen;
 
@@ -98,6 +238,107 @@ uint8_t computeRank(PointView& view, std::vector<PointId> ids, double threshold)
     return static_cast<uint8_t>(svd.rank());
 }
 
+std::vector<EigenFeatures> computeEigenFeatures(const PointView& view,
+    const NeighborTable& neighbors, std::size_t threads)
+{
+    using namespace Dimension;
+    using namespace Eigen;
+
+    const point_count_t np = view.size();
+    const point_count_t nq = neighbors.size();
+    std::vector<EigenFeatures> features(nq);
+    if (nq == 0)
+        return features;
+
+    ThreadPool pool(threads);
+
+    // Interleave the coordinates so that the neighbors of a point are read
+    // with one cache line each rather than through the point table.
+    std::vector<double> xyz(np * 3);
+    const point_count_t numRanges =
+        (std::min)(np, (point_count_t)pool.numThreads() * 4);
+    for (point_count_t b = 0; b < numRanges; ++b)
+    {
+        const PointId begin = np * b / numRanges;
+        const PointId end = np * (b + 1) / numRanges;
+        pool.add([&, begin, end]()
+        {
+            std::vector<double> buf(end - begin);
+            const Id dims[] = { Id::X, Id::Y, Id::Z };
+            for (int d = 0; d < 3; ++d)
+            {
+                view.getFieldsAs(dims[d], begin, end, buf.data());
+                for (PointId i = begin; i < end; ++i)
+                    xyz[i * 3 + d] = buf[i - begin];
+            }
+        });
+    }
+    pool.await();
+
+    const point_count_t numBlocks =
+        (std::min)(nq, (point_count_t)pool.numThreads() * 4);
+    for (point_count_t b = 0; b < numBlocks; ++b)
+    {
+        const PointId begin = nq * b / numBlocks;
+        const PointId end = nq * (b + 1) / numBlocks;
+        pool.add([&, begin, end]()
+        {
+            SelfAdjointEigenSolver<Matrix3d> solver;
+            for (PointId i = begin; i < end; ++i)
+            {
+                EigenFeatures& f = features[i];
+                ColumnSpan<const PointId> ids = neighbors.neighbors(i);
+                const std::size_t n = ids.size();
+                if (n == 0)
+                {
+                    f.values.setZero();
+                    f.normal.setZero();
+                    continue;
+                }
+
+                // Find the centroid of the neighborhood.
+                double mx(0), my(0), mz(0);
+                for (std::size_t k = 0; k < n; ++k)
+                {
+                    const double *p = xyz.data() + ids[k] * 3;
+                    mx += p[0];
+                    my += p[1];
+                    mz += p[2];
+                }
+                mx /= n;
+                my /= n;
+                mz /= n;
+
+                // Accumulate the covariance of the demeaned neighborhood.
+                double xx(0), xy(0), xz(0), yy(0), yz(0), zz(0);
+                for (std::size_t k = 0; k < n; ++k)
+                {
+                    const double *p = xyz.data() + ids[k] * 3;
+                    const double dx = p[0] - mx;
+                    const double dy = p[1] - my;
+                    const double dz = p[2] - mz;
+                    xx += dx * dx;
+                    xy += dx * dy;
+                    xz += dx * dz;
+                    yy += dy * dy;
+                    yz += dy * dz;
+                    zz += dz * dz;
+                }
+                Matrix3d B;
+                B << xx, xy, xz,
+                     xy, yy, yz,
+                     xz, yz, zz;
+
+                solver.computeDirect(B);
+                f.values = solver.eigenvalues();
+                f.normal = solver.eigenvectors().col(0);
+            }
+        });
+    }
+    pool.await();
+    return features;
+}
+
 Eigen::MatrixXd createDSM(PointView& view, int rows, int cols, double cell_size,
                           BOX2D bounds)
 {
@@ -140,4 +381,60 @@ Eigen::MatrixXd createDSM(PointView& view, int rows, int cols, double cell_size,
     return ZImin;
 }
 
+std::vector<int> computeCells(PointView& view, int rows, int cols,
+                              double cell_size, BOX2D bounds,
+                              std::size_t threads)
+{
+    using namespace Dimension;
+
+    const point_count_t np = view.size();
+    std::vector<int> cells(np);
+    if (np == 0)
+        return cells;
+
+    // Match the row origin of createDSM.
+    int maxrow = bounds.miny + rows * cell_size;
+
+    ThreadPool pool(threads);
+    const point_count_t numRanges =
+        (std::min)(np, (point_count_t)pool.numThreads() * 4);
+    for (point_count_t b = 0; b < numRanges; ++b)
+    {
+        const PointId begin = np * b / numRanges;
+        const PointId end = np * (b + 1) / numRanges;
+        pool.add([&, begin, end]()
+        {
+            std::vector<double> x(end - begin);
+            std::vector<double> y(end - begin);
+            view.getFieldsAs(Id::X, begin, end, x.data());
+            view.getFieldsAs(Id::Y, begin, end, y.data());
+            for (PointId i = 0; i < end - begin; ++i)
+            {
+                int c = static_cast<int>(
+                    floor((x[i] - bounds.minx) / cell_size));
+                int r = static_cast<int>(floor((maxrow - y[i]) / cell_size));
+                c = (std::max)(0, (std::min)(c, cols - 1));
+                r = (std::max)(0, (std::min)(r, rows - 1));
+                cells[begin + i] = r + c * rows;
+            }
+        });
+    }
+    pool.await();
+    return cells;
+}
+
+Eigen::MatrixXd erodeDisk(const Eigen::MatrixXd& data, int radius,
+    std::size_t threads)
+{
+    return diskFilter(data, radius, threads,
+        (std::numeric_limits<double>::max)(), std::less<double>());
+}
+
+Eigen::MatrixXd dilateDisk(const Eigen::MatrixXd& data, int radius,
+    std::size_t threads)
+{
+    return diskFilter(data, radius, threads,
+        (std::numeric_limits<double>::lowest)(), std::greater<double>());
+}
+
 } // namespace pdal
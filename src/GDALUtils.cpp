@@ -36,6 +36,7 @@
 #include <pdal/SpatialReference.hpp>
 #include <pdal/util/Utils.hpp>
 
+#include <cmath>
 #include <functional>
 #include <map>
 #include <mutex>
@@ -330,6 +331,12 @@ Raster::Raster(const std::string& filename)
     , m_raster_y_size(0)
     , m_band_count(0)
     , m_ds(0)
+    , m_blockXSize(1)
+    , m_blockYSize(1)
+    , m_cacheSize(256 * 1024 * 1024)
+    , m_cacheUsed(0)
+    , m_lastKey(0)
+    , m_lastBlock(nullptr)
 {
     m_forward_transform.fill(0);
     m_forward_transform[1] = 1;
@@ -480,7 +487,7 @@ GDALError Raster::readBand(std::vector<uint8_t>& points, int nBand)
     catch (CantReadBlock)
     {
         std::ostringstream oss;
-        oss << "Unable to read block for for raster '" << m_filename << "'.";
+        oss << "Unable to read block for raster '" << m_filename << "'.";
         m_errorMsg = oss.str();
         return GDALError::CantReadBlock;
     }
@@ -494,6 +501,8 @@ GDALError Raster::computePDALDimensionTypes()
         return GDALError::NotOpen;
 
     m_types.clear();
+    m_noData.clear();
+    m_hasNoData.clear();
     for (int i=0; i < m_band_count; ++i)
     {
         GDALRasterBandH band = GDALGetRasterBand(m_ds, i+1);
@@ -511,6 +520,17 @@ GDALError Raster::computePDALDimensionTypes()
         int x(0), y(0);
         GDALGetBlockSize(band, &x, &y);
         m_types.push_back(convertGDALtoPDAL(t));
+
+        int hasNoData(0);
+        m_noData.push_back(GDALGetRasterNoDataValue(band, &hasNoData));
+        m_hasNoData.push_back(hasNoData ? 1 : 0);
+
+        // Blocks of the first band determine how data is cached.
+        if (i == 0)
+        {
+            m_blockXSize = (std::max)(x, 1);
+            m_blockYSize = (std::max)(y, 1);
+        }
     }
     return GDALError::None;
 }
@@ -525,28 +545,222 @@ GDALError Raster::read(double x, double y, std::vector<double>& data)
     int32_t line(0);
     data.resize(m_band_count);
 
-    std::array<double, 2> pix = { {0.0, 0.0} };
-
     // No data at this x,y if we can't compute a pixel/line location
     // for it.
     if (!getPixelAndLinePosition(x, y, pixel, line))
         return GDALError::NoData;
 
-    for (int i=0; i < m_band_count; ++i)
+    const double *values = pixelValues(pixel, line);
+    if (!values)
+        return GDALError::CantReadBlock;
+    std::copy(values, values + m_band_count, data.begin());
+    return GDALError::None;
+}
+
+
+GDALError Raster::read(const double *x, const double *y, std::size_t count,
+    std::vector<double>& data, std::vector<uint8_t>& valid, bool bilinear)
+{
+    if (!m_ds)
+        return GDALError::NotOpen;
+
+    data.assign(count * m_band_count, 0.0);
+    valid.assign(count, 0);
+
+    // Find the fractional pixel/line position of each location and sort
+    // the locations that fall in the raster by block.
+    struct Location
+    {
+        uint64_t m_key;
+        std::size_t m_idx;
+        double m_pixel;
+        double m_line;
+
+        bool operator<(const Location& other) const
+            { return m_key < other.m_key; }
+    };
+
+    const std::array<double, 6>& inv = m_inverse_transform;
+    std::vector<Location> locs;
+    locs.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        double pixel = inv[0] + inv[1] * x[i] + inv[2] * y[i];
+        double line = inv[3] + inv[4] * x[i] + inv[5] * y[i];
+        if (pixel < 0 || pixel >= m_raster_x_size ||
+            line < 0 || line >= m_raster_y_size)
+            continue;
+        uint64_t key = ((uint64_t)((int)line / m_blockYSize) << 32) |
+            (uint32_t)((int)pixel / m_blockXSize);
+        locs.push_back({key, i, pixel, line});
+    }
+    std::stable_sort(locs.begin(), locs.end());
+
+    // Pointers from pixelValues() don't survive later calls, so the
+    // samples for bilinear interpolation are copied here.
+    std::vector<double> samples(bilinear ? 4 * m_band_count : 0);
+    for (const Location& loc : locs)
     {
-        GDALRasterBandH b = GDALGetRasterBand(m_ds, i+1);
-        if (GDALRasterIO(b, GF_Read, pixel, line, 1, 1,
-            &pix[0], 1, 1, GDT_CFloat64, 0, 0) == CE_None)
+        double *out = data.data() + loc.m_idx * m_band_count;
+        if (!bilinear)
         {
-            // we read a pixel put its values in our vector
-            data[i] = pix[0];
+            const double *values =
+                pixelValues((int)loc.m_pixel, (int)loc.m_line);
+            if (!values)
+                return GDALError::CantReadBlock;
+            std::copy(values, values + m_band_count, out);
         }
+        else
+        {
+            // Interpolate between the centers of the surrounding pixels,
+            // clamping at the edges of the raster.
+            double px = loc.m_pixel - .5;
+            double py = loc.m_line - .5;
+            int p0 = (int)std::floor(px);
+            int l0 = (int)std::floor(py);
+            double wx = px - p0;
+            double wy = py - l0;
+            int p1 = (std::min)(p0 + 1, m_raster_x_size - 1);
+            int l1 = (std::min)(l0 + 1, m_raster_y_size - 1);
+            p0 = (std::max)(p0, 0);
+            l0 = (std::max)(l0, 0);
+
+            const int pixels[] = { p0, p1, p0, p1 };
+            const int lines[] = { l0, l0, l1, l1 };
+            const double weights[] = { (1 - wx) * (1 - wy), wx * (1 - wy),
+                (1 - wx) * wy, wx * wy };
+            for (int c = 0; c < 4; ++c)
+            {
+                const double *values = pixelValues(pixels[c], lines[c]);
+                if (!values)
+                    return GDALError::CantReadBlock;
+                std::copy(values, values + m_band_count,
+                    samples.data() + c * m_band_count);
+            }
+
+            // Bands with a nodata sample take the value of the pixel
+            // containing the location rather than mixing nodata in.
+            const double *nearest = nullptr;
+            for (int b = 0; b < m_band_count; ++b)
+            {
+                bool noData = false;
+                for (int c = 0; c < 4; ++c)
+                    noData |= (weights[c] > 0 &&
+                        isNoData(b, samples[c * m_band_count + b]));
+                if (noData)
+                {
+                    if (!nearest)
+                    {
+                        nearest = pixelValues((int)loc.m_pixel,
+                            (int)loc.m_line);
+                        if (!nearest)
+                            return GDALError::CantReadBlock;
+                    }
+                    out[b] = nearest[b];
+                    continue;
+                }
+                for (int c = 0; c < 4; ++c)
+                    out[b] += weights[c] * samples[c * m_band_count + b];
+            }
+        }
+        valid[loc.m_idx] = 1;
     }
-
     return GDALError::None;
 }
 
 
+void Raster::setCacheSize(std::size_t bytes)
+{
+    m_cacheSize = bytes;
+}
+
+
+// Determine if a value is the nodata value of a band.
+bool Raster::isNoData(int band, double value) const
+{
+    if (!m_hasNoData[band])
+        return false;
+    double noData = m_noData[band];
+    return value == noData || (std::isnan(value) && std::isnan(noData));
+}
+
+
+// Get the values of all bands at a pixel, reading the block that contains
+// it into the cache if necessary.  Returns NULL if the block can't be read.
+// The pointer is only valid until the next call.
+const double *Raster::pixelValues(int pixel, int line)
+{
+    int blockX = pixel / m_blockXSize;
+    int blockY = line / m_blockYSize;
+    uint64_t key = ((uint64_t)blockY << 32) | (uint32_t)blockX;
+
+    Block *block = m_lastBlock;
+    if (!block || key != m_lastKey)
+    {
+        auto it = m_blocks.find(key);
+        if (it == m_blocks.end())
+        {
+            block = readBlock(blockX, blockY, key);
+            if (!block)
+                return nullptr;
+        }
+        else
+        {
+            block = &it->second;
+            m_lru.splice(m_lru.begin(), m_lru, block->m_lru);
+        }
+        m_lastKey = key;
+        m_lastBlock = block;
+    }
+
+    std::size_t col = pixel - blockX * m_blockXSize;
+    std::size_t row = line - blockY * m_blockYSize;
+    return block->m_data.data() + (row * block->m_width + col) * m_band_count;
+}
+
+
+// Read all bands of a block into the cache, dropping least recently used
+// blocks to stay within the cache size.
+Raster::Block *Raster::readBlock(int blockX, int blockY, uint64_t key)
+{
+    int x = blockX * m_blockXSize;
+    int y = blockY * m_blockYSize;
+    int width = (std::min)(m_blockXSize, m_raster_x_size - x);
+    int height = (std::min)(m_blockYSize, m_raster_y_size - y);
+
+    std::vector<double> data((std::size_t)width * height * m_band_count);
+    int pixelSpace = sizeof(double) * m_band_count;
+    if (GDALDatasetRasterIO(m_ds, GF_Read, x, y, width, height, data.data(),
+        width, height, GDT_Float64, m_band_count, NULL, pixelSpace,
+        pixelSpace * width, sizeof(double)) != CE_None)
+    {
+        std::ostringstream oss;
+        oss << "Unable to read block for raster '" << m_filename << "'.";
+        m_errorMsg = oss.str();
+        return nullptr;
+    }
+
+    std::size_t size = data.size() * sizeof(double);
+    while (m_lru.size() && m_cacheUsed + size > m_cacheSize)
+    {
+        auto it = m_blocks.find(m_lru.back());
+        m_cacheUsed -= it->second.m_data.size() * sizeof(double);
+        if (&it->second == m_lastBlock)
+            m_lastBlock = nullptr;
+        m_blocks.erase(it);
+        m_lru.pop_back();
+    }
+
+    m_lru.push_front(key);
+    Block& block = m_blocks[key];
+    block.m_data = std::move(data);
+    block.m_width = width;
+    block.m_lru = m_lru.begin();
+    m_cacheUsed += size;
+    return &block;
+}
+
+
 SpatialReference Raster::getSpatialRef() const
 {
     SpatialReference srs;
@@ -571,6 +785,10 @@ void Raster::close()
         m_ds = 0;
     }
     m_types.clear();
+    m_blocks.clear();
+    m_lru.clear();
+    m_cacheUsed = 0;
+    m_lastBlock = nullptr;
 }
 
 } // namespace gdal
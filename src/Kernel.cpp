@@ -41,6 +41,7 @@
 #include <pdal/pdal_config.hpp>
 #include <pdal/StageFactory.hpp>
 #include <pdal/util/ProgramArgs.hpp>
+#include <pdal/util/ThreadPool.hpp>
 
 #include <pdal/pdal_config.hpp>
 
@@ -124,6 +125,7 @@ Kernel::Kernel() :
     m_showTime(false)
     , m_hardCoreDebug(false)
     , m_visualize(false)
+    , m_threads(1)
 {}
 
 
@@ -361,6 +363,9 @@ void Kernel::parseCommonOptions()
     if (m_visualize)
         options.add("visualize", m_visualize);
 
+    if (m_threads != ThreadPool::defaultThreads())
+        options.add("threads", m_threads);
+
     auto pred = [](char c){ return (bool)strchr(",| ", c); };
 
     if (!m_scales.empty())
@@ -439,6 +444,9 @@ void Kernel::addBasicSwitches(ProgramArgs& args)
     args.add("label", "A string to label the process with", m_label);
 
     args.add("visualize", "Visualize result", m_visualize);
+    args.add("threads", "Number of threads each stage may use to process "
+        "points (0 for all hardware threads)", m_threads,
+        ThreadPool::defaultThreads());
     args.add("driver", "Override reader driver", m_driverOverride, "");
     args.add("scale",
          "A comma-separated or quoted, space-separated list of scales to "
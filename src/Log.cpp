@@ -41,6 +41,13 @@
 namespace pdal
 {
 
+namespace
+{
+
+thread_local std::ostream *t_redirect = nullptr;
+
+} // unnamed namespace
+
 Log::Log(std::string const& leaderString,
          std::string const& outputName)
     : m_level(LogLevel::Error)
@@ -121,17 +128,24 @@ std::ostream& Log::get(LogLevel level)
     const auto nativeDebug(Utils::toNative(LogLevel::Debug));
     if (incoming <= stored)
     {
-        *m_log << "(" << leader() << " "<< getLevelString(level) <<": " <<
+        std::ostream& out = t_redirect ? *t_redirect : *m_log;
+        out << "(" << leader() << " "<< getLevelString(level) <<": " <<
             incoming << "): " <<
             std::string(incoming < nativeDebug ? 0 : incoming - nativeDebug,
                     '\t');
-        return *m_log;
+        return out;
     }
     return *m_nullStream;
 
 }
 
 
+void Log::redirectThread(std::ostream *out)
+{
+    t_redirect = out;
+}
+
+
 std::string Log::getLevelString(LogLevel level) const
 {
     switch (level)
@@ -38,6 +38,13 @@
 namespace pdal
 {
 
+std::mutex& MetadataNodeImpl::mutex()
+{
+    static std::mutex s_mutex;
+    return s_mutex;
+}
+
+
 template <>
 void MetadataNodeImpl::setValue(const SpatialReference& ref)
 {
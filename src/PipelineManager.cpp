@@ -205,6 +205,20 @@ point_count_t PipelineManager::execute()
 }
 
 
+// Run the pipeline in streaming mode.  Points pass through the provided
+// table and no point views are kept.
+void PipelineManager::execute(StreamPointTable& table)
+{
+    validateStageOptions();
+
+    Stage *s = getStage();
+    if (!s)
+        return;
+    s->prepare(table);
+    s->execute(table);
+}
+
+
 MetadataNode PipelineManager::getMetadata() const
 {
     MetadataNode output("stages");
@@ -69,18 +69,32 @@ void SimplePointTable::getFieldInternal(Dimension::Id id, PointId idx,
 
 PointTable::~PointTable()
 {
-    for (auto vi = m_blocks.begin(); vi != m_blocks.end(); ++vi)
-        delete [] *vi;
+    char **blocks = m_blocks.load();
+    for (std::size_t i = 0; i < m_numBlocks; ++i)
+        delete [] blocks[i];
 }
 
 PointId PointTable::addPoint()
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
     if (m_numPts % m_blockPtCnt == 0)
     {
+        if (m_numBlocks == m_blockCapacity)
+        {
+            // Readers may still be using the old block array, so it's
+            // retained until the table is destroyed.
+            m_blockCapacity = (std::max)(m_blockCapacity * 2, (size_t)16);
+            std::unique_ptr<char *[]> blocks(new char *[m_blockCapacity]);
+            std::copy(m_blocks.load(), m_blocks.load() + m_numBlocks,
+                blocks.get());
+            m_blocks.store(blocks.get());
+            m_blockArrays.push_back(std::move(blocks));
+        }
         size_t size = pointsToBytes(m_blockPtCnt);
         char *buf = new char[size];
         memset(buf, 0, size);
-        m_blocks.push_back(buf);
+        m_blocks.load()[m_numBlocks++] = buf;
     }
     return m_numPts++;
 }
@@ -88,11 +102,111 @@ PointId PointTable::addPoint()
 
 char *PointTable::getPoint(PointId idx)
 {
-    char *buf = m_blocks[idx / m_blockPtCnt];
+    char *buf = m_blocks.load(std::memory_order_acquire)[idx / m_blockPtCnt];
     return buf + pointsToBytes(idx % m_blockPtCnt);
 }
 
 
+ColumnPointTable::~ColumnPointTable()
+{
+    char **blocks = m_blocks.load();
+    for (std::size_t i = 0; i < m_numBlocks; ++i)
+        delete [] blocks[i];
+}
+
+
+PointId ColumnPointTable::addPoint()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_numPts % m_blockPtCnt == 0)
+    {
+        if (m_numBlocks == m_blockCapacity)
+        {
+            // Readers may still be using the old block array, so it's
+            // retained until the table is destroyed.
+            m_blockCapacity = (std::max)(m_blockCapacity * 2, (size_t)16);
+            std::unique_ptr<char *[]> blocks(new char *[m_blockCapacity]);
+            std::copy(m_blocks.load(), m_blocks.load() + m_numBlocks,
+                blocks.get());
+            m_blocks.store(blocks.get());
+            m_blockArrays.push_back(std::move(blocks));
+        }
+        size_t size = m_layoutRef.pointSize() * m_blockPtCnt;
+        char *buf = new char[size];
+        memset(buf, 0, size);
+        m_blocks.load()[m_numBlocks++] = buf;
+    }
+    return m_numPts++;
+}
+
+
+char *ColumnPointTable::getDimension(const Dimension::Detail *d,
+    PointId idx) const
+{
+    char *buf = m_blocks.load(std::memory_order_acquire)[idx / m_blockPtCnt];
+    return buf + d->offset() * m_blockPtCnt +
+        d->size() * (idx % m_blockPtCnt);
+}
+
+
+char *ColumnPointTable::getColumn(const Dimension::Detail *d, PointId idx,
+    point_count_t& count)
+{
+    // Values are contiguous to the end of the block or the last point.
+    point_count_t blockEnd = (idx / m_blockPtCnt + 1) * m_blockPtCnt;
+    count = (std::min)(blockEnd, m_numPts) - idx;
+    return getDimension(d, idx);
+}
+
+
+char *ColumnPointTable::getFieldRun(const Dimension::Detail *d,
+    PointId idx, point_count_t& count, std::size_t& stride)
+{
+    stride = d->size();
+    return getColumn(d, idx, count);
+}
+
+
+char *ColumnPointTable::getPoint(PointId /*idx*/)
+{
+    throw pdal_error("ColumnPointTable doesn't store points contiguously.");
+}
+
+
+void ColumnPointTable::setFieldInternal(Dimension::Id id, PointId idx,
+    const void *value)
+{
+    const Dimension::Detail *d = m_layoutRef.dimDetail(id);
+    const char *src  = (const char *)value;
+    char *dst = getDimension(d, idx);
+    std::copy(src, src + d->size(), dst);
+}
+
+
+void ColumnPointTable::getFieldInternal(Dimension::Id id, PointId idx,
+    void *value) const
+{
+    const Dimension::Detail *d = m_layoutRef.dimDetail(id);
+    const char *src = getDimension(d, idx);
+    char *dst = (char *)value;
+    std::copy(src, src + d->size(), dst);
+}
+
+
+char *PointTable::getFieldRun(const Dimension::Detail *d, PointId idx,
+    point_count_t& count, std::size_t& stride)
+{
+    // Subclasses may keep points elsewhere and not provide a pointer.
+    char *buf = getPoint(idx);
+    if (!buf)
+        return nullptr;
+    count = m_blockPtCnt - idx % m_blockPtCnt;
+    stride = m_layoutRef.pointSize();
+    return buf + d->offset();
+}
+
+
 MetadataNode BasePointTable::toMetadata() const
 {
     const PointLayoutPtr l(layout());
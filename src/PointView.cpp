@@ -34,13 +34,14 @@
 
 #include <iomanip>
 
+#include <pdal/KDIndex.hpp>
 #include <pdal/PointView.hpp>
 #include <pdal/PointViewIter.hpp>
 
 namespace pdal
 {
 
-int PointView::m_lastId = 0;
+std::atomic<int> PointView::m_lastId(0);
 
 PointView::PointView(PointTableRef pointTable) : m_pointTable(pointTable),
 m_size(0), m_id(0)
@@ -54,6 +55,10 @@ PointView::PointView(PointTableRef pointTable, const SpatialReference& srs) :
 	m_id = ++m_lastId;
 }
 
+PointView::~PointView()
+{}
+
+
 PointViewIter PointView::begin()
 {
     return PointViewIter(this, 0);
@@ -76,6 +81,7 @@ void PointView::setFieldInternal(Dimension::Id dim, PointId idx,
         m_index.push_back(rawId);
         m_size++;
         assert(m_temps.empty());
+        clearSpatialIndex();
     }
     else if (idx > size())
     {
@@ -86,13 +92,50 @@ void PointView::setFieldInternal(Dimension::Id dim, PointId idx,
     else
     {
         rawId = m_index[idx];
+        coordsChanged(dim);
     }
     m_pointTable.setFieldInternal(dim, rawId, buf);
 }
 
 
+KD2Index& PointView::build2dIndex(std::size_t threads)
+{
+    if (!m_spatialIndex.kd2)
+    {
+        std::shared_ptr<KD2Index> index(new KD2Index(*this));
+        index->build(threads, true);
+        m_spatialIndex.kd2 = index;
+    }
+    return *m_spatialIndex.kd2;
+}
+
+
+KD3Index& PointView::build3dIndex(std::size_t threads)
+{
+    if (!m_spatialIndex.kd3)
+    {
+        std::shared_ptr<KD3Index> index(new KD3Index(*this));
+        index->build(threads, true);
+        m_spatialIndex.kd3 = index;
+    }
+    return *m_spatialIndex.kd3;
+}
+
+
 void PointView::calculateBounds(BOX2D& output) const
 {
+    using namespace Dimension;
+
+    if (hasColumn<double>(Id::X) && hasColumn<double>(Id::Y))
+    {
+        auto xs = column<double>(Id::X);
+        auto ys = column<double>(Id::Y);
+        for (std::size_t i = 0; i < xs.size(); ++i)
+            for (point_count_t j = 0; j < xs[i].size(); ++j)
+                output.grow(xs[i][j], ys[i][j]);
+        return;
+    }
+
     for (PointId idx = 0; idx < size(); idx++)
     {
         double x = getFieldAs<double>(Dimension::Id::X, idx);
@@ -115,6 +158,20 @@ void PointView::calculateBounds(const PointViewSet& set, BOX2D& output)
 
 void PointView::calculateBounds(BOX3D& output) const
 {
+    using namespace Dimension;
+
+    if (hasColumn<double>(Id::X) && hasColumn<double>(Id::Y) &&
+        hasColumn<double>(Id::Z))
+    {
+        auto xs = column<double>(Id::X);
+        auto ys = column<double>(Id::Y);
+        auto zs = column<double>(Id::Z);
+        for (std::size_t i = 0; i < xs.size(); ++i)
+            for (point_count_t j = 0; j < xs[i].size(); ++j)
+                output.grow(xs[i][j], ys[i][j], zs[i][j]);
+        return;
+    }
+
     for (PointId idx = 0; idx < size(); idx++)
     {
         double x = getFieldAs<double>(Dimension::Id::X, idx);
@@ -0,0 +1,342 @@
+/******************************************************************************
+* Copyright (c) 2016, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/PolygonIndex.hpp>
+#include <pdal/Polygon.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+namespace pdal
+{
+
+namespace
+{
+
+// Cells in the grid per edge of the polygon, and limits on the size of the
+// grid.
+const double CellsPerEdge = 4;
+const double MaxCells = 1 << 22;
+const int MaxGridSize = 4096;
+
+// Tolerance, in cells, when assigning edges to cells, so that a point on
+// an edge that lies along a cell border is found in either cell.
+const double CellTolerance = 1e-9;
+
+void addRing(GEOSContextHandle_t ctx, const GEOSGeometry *ring,
+    std::vector<PolygonIndex::Ring>& rings)
+{
+    const GEOSCoordSequence *coords = GEOSGeom_getCoordSeq_r(ctx, ring);
+    if (!coords)
+        throw pdal_error("Unable to get coordinates of polygon ring.");
+    unsigned int size(0);
+    GEOSCoordSeq_getSize_r(ctx, coords, &size);
+
+    PolygonIndex::Ring r(size);
+    for (unsigned int i = 0; i < size; ++i)
+    {
+        GEOSCoordSeq_getOrdinate_r(ctx, coords, i, 0, &r[i].first);
+        GEOSCoordSeq_getOrdinate_r(ctx, coords, i, 1, &r[i].second);
+    }
+    rings.push_back(std::move(r));
+}
+
+void addPolygons(GEOSContextHandle_t ctx, const GEOSGeometry *geom,
+    std::vector<PolygonIndex::Ring>& rings)
+{
+    switch (GEOSGeomTypeId_r(ctx, geom))
+    {
+    case GEOS_POLYGON:
+    {
+        addRing(ctx, GEOSGetExteriorRing_r(ctx, geom), rings);
+        int numInterior = GEOSGetNumInteriorRings_r(ctx, geom);
+        for (int i = 0; i < numInterior; ++i)
+            addRing(ctx, GEOSGetInteriorRingN_r(ctx, geom, i), rings);
+        break;
+    }
+    case GEOS_MULTIPOLYGON:
+    case GEOS_GEOMETRYCOLLECTION:
+    {
+        int numGeoms = GEOSGetNumGeometries_r(ctx, geom);
+        for (int i = 0; i < numGeoms; ++i)
+            addPolygons(ctx, GEOSGetGeometryN_r(ctx, geom, i), rings);
+        break;
+    }
+    default:
+        throw pdal_error("Unable to index geometry that isn't a polygon "
+            "or multipolygon.");
+    }
+}
+
+} // unnamed namespace
+
+
+PolygonIndex::PolygonIndex(const Polygon& poly)
+{
+    std::vector<Ring> rings;
+    if (poly.m_geom)
+        addPolygons(poly.m_ctx, poly.m_geom, rings);
+    build(rings);
+}
+
+
+PolygonIndex::PolygonIndex(const std::vector<Ring>& rings)
+{
+    build(rings);
+}
+
+
+void PolygonIndex::build(const std::vector<Ring>& rings)
+{
+    m_minx = m_miny = (std::numeric_limits<double>::max)();
+    m_maxx = m_maxy = (std::numeric_limits<double>::lowest)();
+    m_rows = m_cols = 0;
+
+    for (const Ring& ring : rings)
+    {
+        const std::size_t size = ring.size();
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            const auto& a = ring[i];
+            const auto& b = ring[(i + 1) % size];
+            if (a == b)
+                continue;
+            m_edges.push_back({ a.first, a.second, b.first, b.second });
+            m_minx = (std::min)(m_minx, a.first);
+            m_miny = (std::min)(m_miny, a.second);
+            m_maxx = (std::max)(m_maxx, a.first);
+            m_maxy = (std::max)(m_maxy, a.second);
+        }
+    }
+    if (m_edges.empty())
+        return;
+
+    // Pick square-ish cells, a few per edge.
+    const double width = m_maxx - m_minx;
+    const double height = m_maxy - m_miny;
+    const double targetCells =
+        (std::min)(CellsPerEdge * m_edges.size(), MaxCells);
+    double cellSize;
+    if (width > 0 && height > 0)
+        cellSize = std::sqrt(width * height / targetCells);
+    else
+        cellSize = (std::max)(width, height) / targetCells;
+    auto gridSize = [cellSize](double length)
+    {
+        if (length <= 0 || cellSize <= 0)
+            return 1;
+        double n = std::ceil(length / cellSize);
+        return (int)(std::max)(1.0, (std::min)(n, (double)MaxGridSize));
+    };
+    m_cols = gridSize(width);
+    m_rows = gridSize(height);
+    m_cellWidth = width > 0 ? width / m_cols : 1;
+    m_cellHeight = height > 0 ? height / m_rows : 1;
+
+    auto clampIndex = [](double v, int size)
+        { return (int)(std::max)(0.0, (std::min)(v, (double)(size - 1))); };
+
+    // Call 'f' with each row an edge crosses and the columns it spans in
+    // that row.
+    auto visit = [&](const Edge& e, std::function<void(int, int, int)> f)
+    {
+        const double ylo = (std::min)(e.y0, e.y1);
+        const double yhi = (std::max)(e.y0, e.y1);
+        const int r0 = clampIndex(std::floor(
+            (ylo - m_miny) / m_cellHeight - CellTolerance), m_rows);
+        const int r1 = clampIndex(std::floor(
+            (yhi - m_miny) / m_cellHeight + CellTolerance), m_rows);
+        for (int r = r0; r <= r1; ++r)
+        {
+            double xlo = (std::min)(e.x0, e.x1);
+            double xhi = (std::max)(e.x0, e.x1);
+            if (e.y0 != e.y1)
+            {
+                // Clip the edge to the row.
+                const double rowLo = m_miny + (r - CellTolerance) *
+                    m_cellHeight;
+                const double rowHi = m_miny + (r + 1 + CellTolerance) *
+                    m_cellHeight;
+                auto xAt = [&e](double y)
+                {
+                    double t = (y - e.y0) / (e.y1 - e.y0);
+                    t = (std::max)(0.0, (std::min)(t, 1.0));
+                    return e.x0 + t * (e.x1 - e.x0);
+                };
+                const double xa = xAt(rowLo);
+                const double xb = xAt(rowHi);
+                xlo = (std::min)(xa, xb);
+                xhi = (std::max)(xa, xb);
+            }
+            const int c0 = clampIndex(std::floor(
+                (xlo - m_minx) / m_cellWidth - CellTolerance), m_cols);
+            const int c1 = clampIndex(std::floor(
+                (xhi - m_minx) / m_cellWidth + CellTolerance), m_cols);
+            f(r, c0, c1);
+        }
+    };
+
+    // Count, then fill, the edges of each cell and each row.
+    const std::size_t numCells = (std::size_t)m_rows * m_cols;
+    m_cellOffsets.assign(numCells + 1, 0);
+    m_rowOffsets.assign(m_rows + 1, 0);
+    for (const Edge& e : m_edges)
+        visit(e, [this](int r, int c0, int c1)
+        {
+            m_rowOffsets[r + 1]++;
+            for (int c = c0; c <= c1; ++c)
+                m_cellOffsets[(std::size_t)r * m_cols + c + 1]++;
+        });
+    for (std::size_t i = 0; i < numCells; ++i)
+        m_cellOffsets[i + 1] += m_cellOffsets[i];
+    for (int r = 0; r < m_rows; ++r)
+        m_rowOffsets[r + 1] += m_rowOffsets[r];
+
+    m_cellEdges.resize(m_cellOffsets.back());
+    m_rowEdges.resize(m_rowOffsets.back());
+    std::vector<std::size_t> cellPos(m_cellOffsets.begin(),
+        m_cellOffsets.end() - 1);
+    std::vector<std::size_t> rowPos(m_rowOffsets.begin(),
+        m_rowOffsets.end() - 1);
+    for (uint32_t i = 0; i < m_edges.size(); ++i)
+        visit(m_edges[i], [&, i](int r, int c0, int c1)
+        {
+            m_rowEdges[rowPos[r]++] = i;
+            for (int c = c0; c <= c1; ++c)
+                m_cellEdges[cellPos[(std::size_t)r * m_cols + c]++] = i;
+        });
+
+    // Classify the cells that no edge crosses by counting the crossings of
+    // a line through the middle of each row to the left of the cell.
+    m_cells.resize(numCells);
+    std::vector<double> crossings;
+    for (int r = 0; r < m_rows; ++r)
+    {
+        const double y = m_miny + (r + .5) * m_cellHeight;
+        crossings.clear();
+        for (std::size_t i = m_rowOffsets[r]; i < m_rowOffsets[r + 1]; ++i)
+        {
+            const Edge& e = m_edges[m_rowEdges[i]];
+            if ((e.y0 > y) != (e.y1 > y))
+                crossings.push_back(e.x0 +
+                    (y - e.y0) * (e.x1 - e.x0) / (e.y1 - e.y0));
+        }
+        std::sort(crossings.begin(), crossings.end());
+
+        std::size_t left = 0;
+        for (int c = 0; c < m_cols; ++c)
+        {
+            const std::size_t cell = (std::size_t)r * m_cols + c;
+            if (m_cellOffsets[cell] != m_cellOffsets[cell + 1])
+            {
+                m_cells[cell] = CellState::Boundary;
+                continue;
+            }
+            const double x = m_minx + (c + .5) * m_cellWidth;
+            while (left < crossings.size() && crossings[left] < x)
+                left++;
+            m_cells[cell] = (left % 2) ? CellState::Inside :
+                CellState::Outside;
+        }
+    }
+}
+
+
+bool PolygonIndex::exactCovers(int row, int cell, double x, double y) const
+{
+    // A point on an edge lies in the cell the edge crosses.
+    for (std::size_t i = m_cellOffsets[cell]; i < m_cellOffsets[cell + 1];
+        ++i)
+    {
+        const Edge& e = m_edges[m_cellEdges[i]];
+        const double cross = (e.x1 - e.x0) * (y - e.y0) -
+            (e.y1 - e.y0) * (x - e.x0);
+        if (cross == 0 &&
+            x >= (std::min)(e.x0, e.x1) && x <= (std::max)(e.x0, e.x1) &&
+            y >= (std::min)(e.y0, e.y1) && y <= (std::max)(e.y0, e.y1))
+            return true;
+    }
+
+    // Count the edges crossed by a ray to the right of the point.  Every
+    // edge that spans the point's y lies in the point's row.
+    bool inside = false;
+    for (std::size_t i = m_rowOffsets[row]; i < m_rowOffsets[row + 1]; ++i)
+    {
+        const Edge& e = m_edges[m_rowEdges[i]];
+        if ((e.y0 > y) == (e.y1 > y))
+            continue;
+        const double cross = (e.x1 - e.x0) * (y - e.y0) -
+            (e.y1 - e.y0) * (x - e.x0);
+        // The edge is to the right when the point is to the left of an
+        // upward edge or to the right of a downward one.
+        if ((e.y1 > e.y0) == (cross > 0))
+            inside = !inside;
+    }
+    return inside;
+}
+
+
+bool PolygonIndex::covers(double x, double y) const
+{
+    if (m_cells.empty() ||
+        !(x >= m_minx && x <= m_maxx && y >= m_miny && y <= m_maxy))
+        return false;
+
+    const int row = (std::min)((int)((y - m_miny) / m_cellHeight),
+        m_rows - 1);
+    const int col = (std::min)((int)((x - m_minx) / m_cellWidth),
+        m_cols - 1);
+    const int cell = row * m_cols + col;
+    switch (m_cells[cell])
+    {
+    case CellState::Inside:
+        return true;
+    case CellState::Outside:
+        return false;
+    default:
+        return exactCovers(row, cell, x, y);
+    }
+}
+
+
+void PolygonIndex::covers(const double *x, const double *y,
+    point_count_t count, uint8_t *covered) const
+{
+    for (point_count_t i = 0; i < count; ++i)
+        covered[i] = covers(x[i], y[i]) ? 1 : 0;
+}
+
+} // namespace pdal
@@ -39,16 +39,66 @@
 #include <pdal/SpatialReference.hpp>
 #include <pdal/PDALUtils.hpp>
 #include <pdal/util/ProgramArgs.hpp>
+#include <pdal/util/ThreadPool.hpp>
 
 #include "StageRunner.hpp"
 
+#include <algorithm>
+#include <condition_variable>
 #include <iterator>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 namespace pdal
 {
 
-Stage::Stage() : m_progressFd(-1), m_debug(false), m_verbose(0)
+namespace
+{
+
+// One buffer in the ring used by pipelined streaming.  All buffers share
+// the layout of the table provided to execute().
+class RingPointTable : public StreamPointTable
+{
+public:
+    RingPointTable(PointLayout& layout, point_count_t capacity) :
+        StreamPointTable(layout), m_capacity(capacity)
+    { m_buf.resize(pointsToBytes(m_capacity + 1)); }
+
+    point_count_t capacity() const
+        { return m_capacity; }
+protected:
+    virtual char *getPoint(PointId idx)
+        { return m_buf.data() + pointsToBytes(idx); }
+
+private:
+    std::vector<char> m_buf;
+    point_count_t m_capacity;
+};
+
+struct RingSlot
+{
+    RingSlot(PointLayout& layout, point_count_t capacity) :
+        m_table(layout, capacity), m_skips(capacity), m_count(0),
+        m_last(false), m_group(0)
+    {}
+
+    RingPointTable m_table;
+    SkipMask m_skips;
+    point_count_t m_count;    // Number of points loaded by the reader.
+    bool m_last;              // Set when the reader has run out of points.
+    std::size_t m_group;      // Stage group that may use the slot next.
+};
+typedef std::unique_ptr<RingSlot> RingSlotPtr;
+
+// Set on a thread while it runs one of several views being run through a
+// stage concurrently.
+thread_local bool t_viewThread = false;
+
+} // unnamed namespace
+
+Stage::Stage() : m_progressFd(-1), m_debug(false), m_verbose(0),
+    m_threads(1), m_pipelineThreads(1)
 {}
 
 
@@ -176,17 +226,27 @@ PointViewSet Stage::execute(PointTableRef table)
     gdal::ErrorHandler::getGlobalErrorHandler().set(m_log, m_debug);
 
     // Do the ready operation and then start running all the views
-    // through the stage.
+    // through the stage.  The pool runs views synchronously unless the
+    // stage can handle several at once.
     ready(table);
+    std::size_t numThreads = 1;
+    if (parallelSafe() && views.size() > 1 && m_threads != 1)
+    {
+        numThreads = m_threads ? m_threads :
+            std::thread::hardware_concurrency();
+        numThreads = (std::max)(numThreads, (std::size_t)1);
+        numThreads = (std::min)(numThreads, (std::size_t)views.size());
+    }
+    ThreadPool pool(numThreads);
     for (auto const& it : views)
     {
-        StageRunnerPtr runner(new StageRunner(this, it));
+        StageRunnerPtr runner(new StageRunner(pool, this, it));
         runners.push_back(runner);
         runner->run();
     }
 
-    // As the stages complete (synchronously at this time), propagate the
-    // spatial reference and merge the output views.
+    // As the stages complete, propagate the spatial reference and merge
+    // the output views.
     srs = getSpatialReference();
     for (auto const& it : runners)
     {
@@ -206,6 +266,15 @@ PointViewSet Stage::execute(PointTableRef table)
 }
 
 
+bool Stage::pipelineStreamable() const
+{
+    for (const Stage *s : m_inputs)
+        if (!s->pipelineStreamable())
+            return false;
+    return streamable();
+}
+
+
 // Streamed execution.
 void Stage::execute(StreamPointTable& table)
 {
@@ -255,7 +324,7 @@ void Stage::execute(StreamPointTable& table)
 
 void Stage::execute(StreamPointTable& table, std::list<Stage *>& stages)
 {
-    std::vector<bool> skips(table.capacity());
+    SkipMask skips(table.capacity());
     std::list<Stage *> filters;
     SpatialReference srs;
 
@@ -276,57 +345,54 @@ void Stage::execute(StreamPointTable& table, std::list<Stage *>& stages)
             table.setSpatialReference(srs);
     }
 
+    // Run the stages on several threads if asked.  There's no point in
+    // using more threads than there are stages.
+    std::size_t numThreads = m_pipelineThreads ? m_pipelineThreads :
+        std::thread::hardware_concurrency();
+    numThreads = (std::min)(numThreads, stages.size());
+    bool finished = false;
+    if (numThreads > 1)
+    {
+        executePipelined(table, stages, numThreads);
+        finished = true;
+    }
+
     // Loop until we're finished.  We handle the number of points up to
     // the capacity of the StreamPointTable that we've been provided.
-
-    bool finished = false;
     while (!finished)
     {
         // Clear the spatial reference when processing starts.
         table.clearSpatialReferences();
-        PointId idx = 0;
-        PointRef point(table, idx);
         point_count_t pointLimit = table.capacity();
 
+        // When the reader returns fewer points than we asked for, we're
+        // done, so set the point limit to the number of points read in
+        // this loop of the table.
         reader->pushLogLeader();
-        // When we get false back from a reader, we're done, so set
-        // the point limit to the number of points processed in this loop
-        // of the table.
-        for (PointId idx = 0; idx < pointLimit; idx++)
+        point_count_t count = reader->processBatch(table, pointLimit, skips);
+        if (count < pointLimit)
         {
-            point.setPointId(idx);
-            finished = !reader->processOne(point);
-            if (finished)
-                pointLimit = idx;
+            finished = true;
+            pointLimit = count;
         }
         reader->popLogLeader();
         srs = reader->getSpatialReference();
         if (!srs.empty())
             table.setSpatialReference(srs);
 
-        // When we get a false back from a filter, we're filtering out a
-        // point, so add it to the list of skips so that it doesn't get
-        // processed by subsequent filters.
+        // Filters mark the points they filter out in the skip mask so that
+        // they don't get processed by subsequent filters.
         for (Stage *s : filters)
         {
             s->pushLogLeader();
-            for (PointId idx = 0; idx < pointLimit; idx++)
-            {
-                if (skips[idx])
-                    continue;
-                point.setPointId(idx);
-                if (!s->processOne(point))
-                    skips[idx] = true;
-            }
+            s->processBatch(table, pointLimit, skips);
             srs = s->getSpatialReference();
             if (!srs.empty())
                 table.setSpatialReference(srs);
             s->popLogLeader();
         }
 
-        // Yes, vector<bool> is terrible.  Can do something better later.
-        for (size_t i = 0; i < skips.size(); ++i)
-            skips[i] = false;
+        std::fill(skips.begin(), skips.end(), 0);
         table.reset();
     }
 
@@ -338,6 +404,142 @@ void Stage::execute(StreamPointTable& table, std::list<Stage *>& stages)
     }
 }
 
+
+// Pipelined streamed execution.  The stages are split into groups, each
+// of which runs on its own thread.  Batches of points move through a ring
+// of tables from one group to the next in order.  A group waits when the
+// next slot in the ring hasn't been released by the group before it, which
+// bounds memory use to the size of the ring.
+void Stage::executePipelined(StreamPointTable& table,
+    std::list<Stage *>& stages, std::size_t numThreads)
+{
+    typedef std::vector<Stage *> StageGroup;
+
+    // Split the stages into contiguous groups, one per thread.  Earlier
+    // groups get any extra stages so that the last stage, usually a writer,
+    // tends to get a thread of its own.
+    std::vector<StageGroup> groups(numThreads);
+    std::size_t idx = 0;
+    for (Stage *s : stages)
+        groups[idx++ * numThreads / stages.size()].push_back(s);
+
+    // One more buffer than there are groups lets the reader get ahead
+    // while every other group is busy.
+    std::vector<RingSlotPtr> ring;
+    for (std::size_t i = 0; i < numThreads + 1; ++i)
+        ring.push_back(RingSlotPtr(
+            new RingSlot(*table.layout(), table.capacity())));
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool abort(false);
+
+    // The log leader stack is shared by the stages and isn't thread safe,
+    // so it isn't pushed/popped here.
+    auto work = [&](std::size_t g)
+    {
+        const StageGroup& group = groups[g];
+        const std::size_t next = (g + 1) % groups.size();
+        std::size_t pos = 0;
+        bool last = false;
+
+        try
+        {
+            while (!last)
+            {
+                RingSlot& slot = *ring[pos];
+                pos = (pos + 1) % ring.size();
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait(lock, [&]{ return abort || slot.m_group == g; });
+                    if (abort)
+                        return;
+                }
+
+                StreamPointTable& t = slot.m_table;
+                auto si = group.begin();
+                if (g == 0)
+                {
+                    // Clear the spatial reference when processing starts.
+                    t.clearSpatialReferences();
+                    Stage *reader = *si++;
+                    point_count_t capacity = t.capacity();
+                    slot.m_count =
+                        reader->processBatch(t, capacity, slot.m_skips);
+                    slot.m_last = (slot.m_count < capacity);
+                    SpatialReference srs = reader->getSpatialReference();
+                    if (!srs.empty())
+                        t.setSpatialReference(srs);
+                }
+                for (; si != group.end(); ++si)
+                {
+                    Stage *s = *si;
+                    s->processBatch(t, slot.m_count, slot.m_skips);
+                    SpatialReference srs = s->getSpatialReference();
+                    if (!srs.empty())
+                        t.setSpatialReference(srs);
+                }
+                last = slot.m_last;
+
+                // The last group hands the slot back to the reader.
+                if (next == 0)
+                {
+                    std::fill(slot.m_skips.begin(), slot.m_skips.end(), 0);
+                    t.reset();
+                }
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    slot.m_group = next;
+                }
+                cv.notify_all();
+            }
+        }
+        catch (...)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                abort = true;
+            }
+            cv.notify_all();
+            throw;
+        }
+    };
+
+    ThreadPool pool(numThreads);
+    for (std::size_t g = 0; g < numThreads; ++g)
+        pool.add(std::bind(work, g));
+    pool.await();
+}
+
+
+point_count_t Stage::processBatch(StreamPointTable& table,
+    point_count_t count, SkipMask& skips)
+{
+    PointRef point(table, 0);
+
+    // Readers have no inputs.
+    if (m_inputs.empty())
+    {
+        for (PointId idx = 0; idx < count; idx++)
+        {
+            point.setPointId(idx);
+            if (!processOne(point))
+                return idx;
+        }
+        return count;
+    }
+
+    for (PointId idx = 0; idx < count; idx++)
+    {
+        if (skips[idx])
+            continue;
+        point.setPointId(idx);
+        if (!processOne(point))
+            skips[idx] = 1;
+    }
+    return count;
+}
+
 void Stage::l_done(PointTableRef table)
 {
     done(table);
@@ -346,10 +548,27 @@ void Stage::l_done(PointTableRef table)
 void Stage::l_addArgs(ProgramArgs& args)
 {
     args.add("log", "Debug output filename", m_logname);
+    args.add("threads", "Number of threads used to process points",
+        m_threads, ThreadPool::defaultThreads());
+    args.add("pipeline_threads", "Number of threads used to pipeline "
+        "streamed execution ending at this stage", m_pipelineThreads,
+        (std::size_t)1);
     readerAddArgs(args);
 }
 
 
+std::size_t Stage::threads() const
+{
+    return t_viewThread ? 1 : m_threads;
+}
+
+
+void Stage::setViewThread(bool viewThread)
+{
+    t_viewThread = viewThread;
+}
+
+
 void Stage::setupLog()
 {
     LogLevel l(LogLevel::Error);
@@ -34,9 +34,12 @@
 
 #pragma once
 
+#include <future>
 #include <memory>
+#include <sstream>
 
 #include <pdal/Stage.hpp>
+#include <pdal/util/ThreadPool.hpp>
 
 namespace pdal
 {
@@ -44,21 +47,70 @@ namespace pdal
 class StageRunner
 {
 public:
-    StageRunner(Stage *s, PointViewPtr view) :
-        m_stage(s), m_view(view)
+    StageRunner(ThreadPool& pool, Stage *s, PointViewPtr view) :
+        m_pool(pool), m_stage(s), m_view(view)
     {}
 
-    // For now this is all synchronous
+    // Queue the view to be run through the stage on the pool.  When views
+    // run concurrently, each one's log output is buffered and written out
+    // when it's waited on, and the stage uses a single thread for each.
     void run()
-        { m_viewSet = m_stage->run(m_view); }
+    {
+        Stage *stage = m_stage;
+        PointViewPtr view = m_view;
+        const bool concurrent = m_pool.numThreads() > 1;
+        std::shared_ptr<std::ostringstream> logBuf;
+        if (concurrent)
+            logBuf.reset(new std::ostringstream);
+        m_logBuf = logBuf;
+        auto task = std::make_shared<std::packaged_task<PointViewSet()>>(
+            [stage, view, logBuf, concurrent]()
+            {
+                LogRedirect redirect(logBuf.get());
+                ViewThread viewThread(concurrent);
+                return stage->run(view);
+            });
+        m_viewSet = task->get_future();
+        m_pool.add([task](){ (*task)(); });
+    }
 
+    // Block until the view has been run, rethrowing any exception raised
+    // by the stage.
     PointViewSet wait()
-        { return m_viewSet; }
+    {
+        m_viewSet.wait();
+        if (m_logBuf)
+        {
+            LogPtr log = m_stage->log();
+            if (log)
+                *log->getLogStream() << m_logBuf->str();
+            m_logBuf.reset();
+        }
+        return m_viewSet.get();
+    }
 
 private:
+    struct LogRedirect
+    {
+        LogRedirect(std::ostream *out)
+            { Log::redirectThread(out); }
+        ~LogRedirect()
+            { Log::redirectThread(nullptr); }
+    };
+
+    struct ViewThread
+    {
+        ViewThread(bool viewThread)
+            { Stage::setViewThread(viewThread); }
+        ~ViewThread()
+            { Stage::setViewThread(false); }
+    };
+
+    ThreadPool& m_pool;
     Stage *m_stage;
     PointViewPtr m_view;
-    PointViewSet m_viewSet;
+    std::future<PointViewSet> m_viewSet;
+    std::shared_ptr<std::ostringstream> m_logBuf;
 };
 typedef std::shared_ptr<StageRunner> StageRunnerPtr;
 
@@ -0,0 +1,192 @@
+/******************************************************************************
+* Copyright (c) 2016, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/util/Affine.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PDAL_AFFINE_SSE2
+#include <emmintrin.h>
+#endif
+
+// AVX code is compiled with a target attribute and only run when the
+// processor supports it, so the library can be built for any x86.
+#if defined(PDAL_AFFINE_SSE2) && defined(__GNUC__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define PDAL_AFFINE_AVX
+#include <immintrin.h>
+#endif
+
+namespace pdal
+{
+
+namespace
+{
+
+typedef void (*KernelFunc)(const double *m, std::size_t count, double *x,
+    double *y, double *z);
+
+// Each kernel evaluates the terms in the same order, without fused
+// multiply-adds, so that all give the same results.
+void affineScalar(const double *m, std::size_t count, double *x, double *y,
+    double *z)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const double xi = x[i];
+        const double yi = y[i];
+        const double zi = z[i];
+        x[i] = xi * m[0] + yi * m[1] + zi * m[2] + m[3];
+        y[i] = xi * m[4] + yi * m[5] + zi * m[6] + m[7];
+        z[i] = xi * m[8] + yi * m[9] + zi * m[10] + m[11];
+    }
+}
+
+#ifdef PDAL_AFFINE_SSE2
+void affineSse2(const double *m, std::size_t count, double *x, double *y,
+    double *z)
+{
+    __m128d c[12];
+    for (int i = 0; i < 12; ++i)
+        c[i] = _mm_set1_pd(m[i]);
+
+    auto row = [&c](int r, __m128d xi, __m128d yi, __m128d zi)
+    {
+        __m128d v = _mm_add_pd(_mm_mul_pd(xi, c[r * 4]),
+            _mm_mul_pd(yi, c[r * 4 + 1]));
+        v = _mm_add_pd(v, _mm_mul_pd(zi, c[r * 4 + 2]));
+        return _mm_add_pd(v, c[r * 4 + 3]);
+    };
+
+    std::size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        const __m128d xi = _mm_loadu_pd(x + i);
+        const __m128d yi = _mm_loadu_pd(y + i);
+        const __m128d zi = _mm_loadu_pd(z + i);
+        _mm_storeu_pd(x + i, row(0, xi, yi, zi));
+        _mm_storeu_pd(y + i, row(1, xi, yi, zi));
+        _mm_storeu_pd(z + i, row(2, xi, yi, zi));
+    }
+    affineScalar(m, count - i, x + i, y + i, z + i);
+}
+#endif
+
+#ifdef PDAL_AFFINE_AVX
+__attribute__((target("avx")))
+void affineAvx(const double *m, std::size_t count, double *x, double *y,
+    double *z)
+{
+    __m256d c[12];
+    for (int i = 0; i < 12; ++i)
+        c[i] = _mm256_set1_pd(m[i]);
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m256d xi = _mm256_loadu_pd(x + i);
+        const __m256d yi = _mm256_loadu_pd(y + i);
+        const __m256d zi = _mm256_loadu_pd(z + i);
+        __m256d out[3];
+        for (int r = 0; r < 3; ++r)
+        {
+            __m256d v = _mm256_add_pd(_mm256_mul_pd(xi, c[r * 4]),
+                _mm256_mul_pd(yi, c[r * 4 + 1]));
+            v = _mm256_add_pd(v, _mm256_mul_pd(zi, c[r * 4 + 2]));
+            out[r] = _mm256_add_pd(v, c[r * 4 + 3]);
+        }
+        _mm256_storeu_pd(x + i, out[0]);
+        _mm256_storeu_pd(y + i, out[1]);
+        _mm256_storeu_pd(z + i, out[2]);
+    }
+    affineSse2(m, count - i, x + i, y + i, z + i);
+}
+#endif
+
+// Find the function for a kernel.  Returns null if the kernel isn't
+// available.
+KernelFunc kernelFunc(AffineKernel kernel)
+{
+    switch (kernel)
+    {
+    case AffineKernel::Scalar:
+        return affineScalar;
+    case AffineKernel::Sse2:
+#ifdef PDAL_AFFINE_SSE2
+        return affineSse2;
+#else
+        return nullptr;
+#endif
+    case AffineKernel::Avx:
+#ifdef PDAL_AFFINE_AVX
+        if (__builtin_cpu_supports("avx"))
+            return affineAvx;
+#endif
+        return nullptr;
+    }
+    return nullptr;
+}
+
+KernelFunc selectKernel()
+{
+    KernelFunc func = kernelFunc(AffineKernel::Avx);
+    if (!func)
+        func = kernelFunc(AffineKernel::Sse2);
+    if (!func)
+        func = affineScalar;
+    return func;
+}
+
+} // unnamed namespace
+
+
+void affineTransform(const double *m, std::size_t count, double *x,
+    double *y, double *z)
+{
+    static const KernelFunc kernel = selectKernel();
+    kernel(m, count, x, y, z);
+}
+
+
+bool affineTransform(AffineKernel kernel, const double *m, std::size_t count,
+    double *x, double *y, double *z)
+{
+    KernelFunc func = kernelFunc(kernel);
+    if (!func)
+        return false;
+    func(m, count, x, y, z);
+    return true;
+}
+
+} // namespace pdal
@@ -34,6 +34,16 @@
 
 #include <sys/stat.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 
@@ -347,6 +357,98 @@ std::string extension(const std::string& filename)
     return filename.substr(idx);
 }
 
+
+MapContext mapFile(const string& filename)
+{
+    MapContext ctx;
+
+    if (isStdin(filename))
+    {
+        ctx.m_error = "Can't map standard input.";
+        return ctx;
+    }
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ,
+        FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        ctx.m_error = "Unable to open file.";
+        return ctx;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        ctx.m_error = "Unable to map empty file.";
+        return ctx;
+    }
+    HANDLE mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL)
+    {
+        ctx.m_error = "Unable to create file mapping.";
+        return ctx;
+    }
+    ctx.m_addr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (ctx.m_addr == NULL)
+    {
+        CloseHandle(mapping);
+        ctx.m_error = "Unable to map file.";
+        return ctx;
+    }
+    ctx.m_handle = mapping;
+    ctx.m_size = (uint64_t)size.QuadPart;
+#else
+    ctx.m_fd = ::open(filename.c_str(), O_RDONLY);
+    if (ctx.m_fd == -1)
+    {
+        ctx.m_error = "Unable to open file: " + string(strerror(errno));
+        return ctx;
+    }
+    struct stat st;
+    if (fstat(ctx.m_fd, &st) != 0 || st.st_size == 0)
+    {
+        ::close(ctx.m_fd);
+        ctx.m_fd = -1;
+        ctx.m_error = "Unable to map empty file.";
+        return ctx;
+    }
+    void *addr = ::mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, ctx.m_fd, 0);
+    if (addr == MAP_FAILED)
+    {
+        ::close(ctx.m_fd);
+        ctx.m_fd = -1;
+        ctx.m_error = "Unable to map file: " + string(strerror(errno));
+        return ctx;
+    }
+    ctx.m_addr = addr;
+    ctx.m_size = (uint64_t)st.st_size;
+#endif
+    return ctx;
+}
+
+
+MapContext unmapFile(MapContext ctx)
+{
+#ifdef _WIN32
+    if (ctx.m_addr)
+        UnmapViewOfFile(ctx.m_addr);
+    if (ctx.m_handle)
+        CloseHandle((HANDLE)ctx.m_handle);
+    ctx.m_handle = NULL;
+#else
+    if (ctx.m_addr)
+        ::munmap(ctx.m_addr, ctx.m_size);
+    if (ctx.m_fd != -1)
+        ::close(ctx.m_fd);
+    ctx.m_fd = -1;
+#endif
+    ctx.m_addr = NULL;
+    ctx.m_size = 0;
+    return ctx;
+}
+
 } // namespace FileUtils
 
 } // namespace pdal
@@ -0,0 +1,184 @@
+/******************************************************************************
+* Copyright (c) 2016, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/util/ThreadPool.hpp>
+#include <pdal/util/Utils.hpp>
+
+#include <algorithm>
+#include <string>
+
+namespace pdal
+{
+
+ThreadPool::ThreadPool(std::size_t numThreads) : m_numThreads(numThreads),
+    m_next(0), m_queued(0), m_outstanding(0), m_stop(false)
+{
+    if (m_numThreads == 0)
+        m_numThreads = (std::max)(std::thread::hardware_concurrency(), 1u);
+
+    // A single thread just runs tasks in the caller.
+    if (m_numThreads == 1)
+        return;
+
+    for (std::size_t i = 0; i < m_numThreads; ++i)
+        m_queues.emplace_back(new Queue);
+    for (std::size_t i = 0; i < m_numThreads; ++i)
+        m_threads.emplace_back(&ThreadPool::work, this, i);
+}
+
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_workCv.notify_all();
+    for (auto& t : m_threads)
+        t.join();
+}
+
+
+std::size_t ThreadPool::defaultThreads()
+{
+    std::string val;
+    int threads;
+
+    if (Utils::getenv("PDAL_NUM_THREADS", val) == 0 &&
+            Utils::fromString(val, threads) && threads >= 0)
+        return (std::size_t)threads;
+    return 1;
+}
+
+
+void ThreadPool::add(Task task)
+{
+    if (m_threads.empty())
+    {
+        runTask(task);
+        return;
+    }
+
+    Queue& q = *m_queues[m_next++ % m_numThreads];
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_outstanding++;
+        m_queued++;
+        std::unique_lock<std::mutex> qlock(q.m_mutex);
+        q.m_tasks.push_back(std::move(task));
+    }
+    m_workCv.notify_one();
+}
+
+
+void ThreadPool::await()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCv.wait(lock, [this](){ return m_outstanding == 0; });
+    if (m_error)
+    {
+        std::exception_ptr error = m_error;
+        m_error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+
+// Take a task from the front of our own queue or, failing that, steal
+// one from the back of another worker's queue.
+bool ThreadPool::pop(std::size_t id, Task& task)
+{
+    for (std::size_t i = 0; i < m_numThreads; ++i)
+    {
+        Queue& q = *m_queues[(id + i) % m_numThreads];
+        std::unique_lock<std::mutex> lock(q.m_mutex);
+        if (q.m_tasks.empty())
+            continue;
+        if (i == 0)
+        {
+            task = std::move(q.m_tasks.front());
+            q.m_tasks.pop_front();
+        }
+        else
+        {
+            task = std::move(q.m_tasks.back());
+            q.m_tasks.pop_back();
+        }
+        return true;
+    }
+    return false;
+}
+
+
+void ThreadPool::runTask(Task& task)
+{
+    try
+    {
+        task();
+    }
+    catch (...)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_error)
+            m_error = std::current_exception();
+    }
+}
+
+
+void ThreadPool::work(std::size_t id)
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_workCv.wait(lock, [this](){ return m_queued || m_stop; });
+            if (!m_queued)
+                return;
+            m_queued--;
+        }
+
+        // A task counted in m_queued is guaranteed to be in some queue
+        // until it's popped, so this will find one.
+        Task task;
+        while (!pop(id, task))
+            std::this_thread::yield();
+        runTask(task);
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (--m_outstanding == 0)
+            m_doneCv.notify_all();
+    }
+}
+
+} // namespace pdal
@@ -0,0 +1,125 @@
+/******************************************************************************
+* Copyright (c) 2016, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <initializer_list>
+#include <random>
+#include <vector>
+
+#include <pdal/util/Affine.hpp>
+
+using namespace pdal;
+
+namespace
+{
+
+void reference(const double *m, std::size_t count, double *x, double *y,
+    double *z)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        double xi = x[i];
+        double yi = y[i];
+        double zi = z[i];
+        x[i] = xi * m[0] + yi * m[1] + zi * m[2] + m[3];
+        y[i] = xi * m[4] + yi * m[5] + zi * m[6] + m[7];
+        z[i] = xi * m[8] + yi * m[9] + zi * m[10] + m[11];
+    }
+}
+
+} // unnamed namespace
+
+// Every kernel available on this machine must give exactly the results of
+// plain code.
+TEST(AffineTest, matchesScalar)
+{
+    const double m[12] = { 0.5, -0.25, 0.125, 100.5,
+                           0.75, 1.5, -2.0, -3000.25,
+                           -0.3, 0.6, 0.9, 12.0 };
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-1e6, 1e6);
+
+    for (AffineKernel kernel :
+        { AffineKernel::Scalar, AffineKernel::Sse2, AffineKernel::Avx })
+    {
+        // Exercise every tail length and unaligned starting offsets.
+        for (std::size_t count = 0; count < 38; ++count)
+        {
+            for (std::size_t offset = 0; offset < 3; ++offset)
+            {
+                std::vector<double> x(count + offset);
+                std::vector<double> y(count + offset);
+                std::vector<double> z(count + offset);
+                for (std::size_t i = 0; i < x.size(); ++i)
+                {
+                    x[i] = dist(gen);
+                    y[i] = dist(gen);
+                    z[i] = dist(gen);
+                }
+                std::vector<double> ex(x), ey(y), ez(z);
+
+                bool available = affineTransform(kernel, m, count,
+                    x.data() + offset, y.data() + offset, z.data() + offset);
+                if (kernel == AffineKernel::Scalar)
+                    ASSERT_TRUE(available);
+                if (!available)
+                    continue;
+                reference(m, count, ex.data() + offset, ey.data() + offset,
+                    ez.data() + offset);
+                EXPECT_EQ(x, ex);
+                EXPECT_EQ(y, ey);
+                EXPECT_EQ(z, ez);
+            }
+        }
+    }
+}
+
+TEST(AffineTest, identity)
+{
+    const double m[12] = { 1, 0, 0, 0,
+                           0, 1, 0, 0,
+                           0, 0, 1, 0 };
+
+    std::vector<double> x { 1.5, -2.5, 3.25, 1e9, -7.0 };
+    std::vector<double> y { 4.5, 5.5, -6.75, 2e9, 8.0 };
+    std::vector<double> z { -7.5, 8.5, 9.125, 3e9, -9.0 };
+    std::vector<double> ex(x), ey(y), ez(z);
+
+    affineTransform(m, x.size(), x.data(), y.data(), z.data());
+    EXPECT_EQ(x, ex);
+    EXPECT_EQ(y, ey);
+    EXPECT_EQ(z, ez);
+}
@@ -0,0 +1,91 @@
+/******************************************************************************
+* Copyright (c) 2016, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <pdal/BoxIndex.hpp>
+
+#include <algorithm>
+
+using namespace pdal;
+
+TEST(BoxIndexTest, query)
+{
+    // Boxes of varied sizes, some overlapping.
+    std::vector<BOX2D> boxes;
+    uint32_t seed = 17;
+    auto rand = [&seed](int range)
+    {
+        seed = seed * 1103515245 + 12345;
+        return (double)((seed >> 8) % range);
+    };
+    for (int i = 0; i < 2000; ++i)
+    {
+        double x = rand(1000);
+        double y = rand(1000);
+        boxes.push_back(BOX2D(x, y, x + 1 + rand(30), y + 1 + rand(30)));
+    }
+    BoxIndex index(boxes);
+
+    std::vector<uint32_t> ids;
+    for (int i = 0; i < 2000; ++i)
+    {
+        // Include points on box corners.
+        double x = (i % 2) ? boxes[i].minx : rand(1050) - 20;
+        double y = (i % 2) ? boxes[i].maxy : rand(1050) - 20;
+
+        std::vector<uint32_t> expected;
+        for (uint32_t j = 0; j < boxes.size(); ++j)
+            if (boxes[j].contains(x, y))
+                expected.push_back(j);
+
+        index.query(x, y, ids);
+        std::sort(ids.begin(), ids.end());
+        EXPECT_EQ(ids, expected) << x << ", " << y;
+    }
+}
+
+TEST(BoxIndexTest, small)
+{
+    BoxIndex empty((std::vector<BOX2D>()));
+    std::vector<uint32_t> ids(1, 5);
+    empty.query(0, 0, ids);
+    EXPECT_TRUE(ids.empty());
+
+    BoxIndex one(std::vector<BOX2D>(1, BOX2D(0, 0, 1, 1)));
+    one.query(.5, .5, ids);
+    EXPECT_EQ(ids, std::vector<uint32_t>(1, 0));
+    one.query(2, .5, ids);
+    EXPECT_TRUE(ids.empty());
+}
@@ -0,0 +1,227 @@
+/******************************************************************************
+* Copyright (c) 2016, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <pdal/Eigen.hpp>
+#include <pdal/KDIndex.hpp>
+#include <pdal/PointView.hpp>
+
+#include <cmath>
+#include <limits>
+
+using namespace pdal;
+using namespace Eigen;
+
+namespace
+{
+
+// Straightforward disk filter to check the fast one against.
+MatrixXd bruteDisk(const MatrixXd& data, int radius, bool erode)
+{
+    MatrixXd out = MatrixXd::Constant(data.rows(), data.cols(), erode ?
+        std::numeric_limits<double>::max() :
+        std::numeric_limits<double>::lowest());
+    for (int c = 0; c < data.cols(); ++c)
+        for (int r = 0; r < data.rows(); ++r)
+            for (int col = c - radius; col <= c + radius; ++col)
+                for (int row = r - radius; row <= r + radius; ++row)
+                {
+                    if (col < 0 || col >= data.cols() || row < 0 ||
+                            row >= data.rows())
+                        continue;
+                    if ((row-r)*(row-r) + (col-c)*(col-c) > radius*radius)
+                        continue;
+                    double v = data(row, col);
+                    if (erode ? v < out(r, c) : v > out(r, c))
+                        out(r, c) = v;
+                }
+    return out;
+}
+
+} // unnamed namespace
+
+TEST(EigenTest, diskMorphology)
+{
+    MatrixXd data(37, 23);
+    uint32_t seed = 99;
+    for (int i = 0; i < data.size(); ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        data(i) = (seed >> 8) % 1000 / 10.0;
+    }
+    for (int i = 0; i < data.size(); i += 7)
+        data(i) = std::numeric_limits<double>::quiet_NaN();
+    // A block of NaN larger than a small disk.
+    data.block(10, 10, 5, 5).setConstant(
+        std::numeric_limits<double>::quiet_NaN());
+
+    for (int radius : { 0, 1, 2, 3, 5, 11, 40 })
+        for (std::size_t threads : { 1, 3 })
+        {
+            EXPECT_TRUE(erodeDisk(data, radius, threads) ==
+                bruteDisk(data, radius, true)) << "radius " << radius;
+            EXPECT_TRUE(dilateDisk(data, radius, threads) ==
+                bruteDisk(data, radius, false)) << "radius " << radius;
+        }
+
+    MatrixXd empty(0, 0);
+    EXPECT_EQ(erodeDisk(empty, 3).size(), 0);
+}
+
+TEST(EigenTest, computeCells)
+{
+    PointTable table;
+    table.layout()->registerDim(Dimension::Id::X);
+    table.layout()->registerDim(Dimension::Id::Y);
+    table.layout()->registerDim(Dimension::Id::Z);
+    PointView view(table);
+
+    uint32_t seed = 7;
+    for (PointId i = 0; i < 500; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        view.setField(Dimension::Id::X, i, (seed >> 8) % 2000 / 100.0);
+        seed = seed * 1103515245 + 12345;
+        view.setField(Dimension::Id::Y, i, (seed >> 8) % 1500 / 100.0);
+        view.setField(Dimension::Id::Z, i, (seed >> 4) % 1000 / 10.0);
+    }
+
+    BOX2D bounds;
+    view.calculateBounds(bounds);
+    const int rows = 9;
+    const int cols = 12;
+    const double cellSize = 2.0;
+
+    // Rasterizing with the cells must match createDSM.
+    MatrixXd dsm = createDSM(view, rows, cols, cellSize, bounds);
+    for (std::size_t threads : { 1, 4 })
+    {
+        std::vector<int> cells =
+            computeCells(view, rows, cols, cellSize, bounds, threads);
+        ASSERT_EQ(cells.size(), view.size());
+
+        MatrixXd zmin = MatrixXd::Constant(rows, cols,
+            std::numeric_limits<double>::quiet_NaN());
+        for (PointId i = 0; i < view.size(); ++i)
+        {
+            ASSERT_GE(cells[i], 0);
+            ASSERT_LT(cells[i], rows * cols);
+            double z = view.getFieldAs<double>(Dimension::Id::Z, i);
+            double& cell = zmin(cells[i]);
+            if (z < cell || std::isnan(cell))
+                cell = z;
+        }
+        for (int i = 0; i < dsm.size(); ++i)
+        {
+            if (std::isnan(dsm(i)))
+                EXPECT_TRUE(std::isnan(zmin(i)));
+            else
+                EXPECT_EQ(dsm(i), zmin(i));
+        }
+    }
+}
+
+TEST(EigenTest, computeEigenFeatures)
+{
+    PointTable table;
+    table.layout()->registerDim(Dimension::Id::X);
+    table.layout()->registerDim(Dimension::Id::Y);
+    table.layout()->registerDim(Dimension::Id::Z);
+    PointView view(table);
+
+    // A noisy tilted plane, with a line of points along one edge.
+    uint32_t seed = 11;
+    PointId id = 0;
+    for (int i = 0; i < 20; ++i)
+        for (int j = 0; j < 20; ++j)
+        {
+            seed = seed * 1103515245 + 12345;
+            double noise = ((seed >> 8) % 100) / 1000.0;
+            view.setField(Dimension::Id::X, id, i);
+            view.setField(Dimension::Id::Y, id, j);
+            view.setField(Dimension::Id::Z, id, 0.5 * i + 0.25 * j + noise);
+            id++;
+        }
+    for (int i = 0; i < 50; ++i)
+    {
+        view.setField(Dimension::Id::X, id, 100 + i);
+        view.setField(Dimension::Id::Y, id, 100);
+        view.setField(Dimension::Id::Z, id, 100);
+        id++;
+    }
+
+    KD3Index& kdi = view.build3dIndex();
+    NeighborTable neighbors = kdi.knnAll(8);
+
+    for (std::size_t threads : { 1, 3 })
+    {
+        std::vector<EigenFeatures> features =
+            computeEigenFeatures(view, neighbors, threads);
+        ASSERT_EQ(features.size(), view.size());
+
+        std::vector<PointId> ids;
+        for (PointId i = 0; i < view.size(); ++i)
+        {
+            ColumnSpan<const PointId> span = neighbors.neighbors(i);
+            ids.assign(span.begin(), span.end());
+            Matrix3d B = computeCovariance(view, ids).cast<double>();
+            SelfAdjointEigenSolver<Matrix3d> solver(B);
+            Vector3d ev = solver.eigenvalues();
+
+            const EigenFeatures& f = features[i];
+            double scale = (std::max)(ev[2], 1.0);
+            for (int k = 0; k < 3; ++k)
+                EXPECT_NEAR(f.values[k], ev[k], 1e-4 * scale);
+            EXPECT_NEAR(f.normal.norm(), 1.0, 1e-6);
+            EXPECT_LE(f.values[0], f.values[1]);
+            EXPECT_LE(f.values[1], f.values[2]);
+
+            // The normal of the plane is along (0.5, 0.25, -1).
+            if (i < 400)
+            {
+                Vector3d n(0.5, 0.25, -1);
+                EXPECT_GT(std::fabs(f.normal.dot(n.normalized())), 0.99);
+                EXPECT_LT(f.scattering(), 0.05);
+            }
+            else
+            {
+                EXPECT_NEAR(f.linearity(), 1.0, 1e-6);
+                EXPECT_NEAR(f.planarity(), 0.0, 1e-6);
+                EXPECT_NEAR(f.scattering(), 0.0, 1e-6);
+                EXPECT_NEAR(f.curvature(), 0.0, 1e-6);
+            }
+        }
+    }
+}
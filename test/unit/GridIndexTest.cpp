@@ -0,0 +1,160 @@
+/******************************************************************************
+* Copyright (c) 2016, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <pdal/GridIndex.hpp>
+#include <pdal/KDIndex.hpp>
+
+using namespace pdal;
+
+namespace
+{
+
+void makePoints(PointView& view, point_count_t count)
+{
+    PointLayoutPtr layout = view.layout();
+    layout->registerDim(Dimension::Id::X);
+    layout->registerDim(Dimension::Id::Y);
+    layout->registerDim(Dimension::Id::Z);
+
+    // Pseudo-random points with a dense cluster and a few far outliers.
+    uint32_t seed = 4321;
+    auto next = [&seed]()
+    {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 8) / double(1 << 24);
+    };
+    for (PointId i = 0; i < count; ++i)
+    {
+        double scale = (i % 4) ? 10.0 : 1.0;
+        if (i % 500 == 7)
+            scale = 300.0;
+        view.setField(Dimension::Id::X, i, next() * scale);
+        view.setField(Dimension::Id::Y, i, next() * scale);
+        view.setField(Dimension::Id::Z, i, next() * scale);
+    }
+}
+
+// Compare neighbor lists by distance, since points at equal distances
+// may come back in a different order.
+void compare(const NeighborTable& expected, const NeighborTable& actual)
+{
+    ASSERT_EQ(expected.size(), actual.size());
+    for (PointId i = 0; i < expected.size(); ++i)
+    {
+        ASSERT_EQ(expected.neighbors(i).size(), actual.neighbors(i).size());
+        ColumnSpan<const double> e = expected.sqrDistances(i);
+        ColumnSpan<const double> a = actual.sqrDistances(i);
+        for (std::size_t j = 0; j < e.size(); ++j)
+            EXPECT_DOUBLE_EQ(e[j], a[j]);
+    }
+}
+
+} // unnamed namespace
+
+TEST(GridIndex, matchesKD3)
+{
+    PointTable table;
+    PointView view(table);
+    makePoints(view, 3000);
+
+    KD3Index kd(view);
+    kd.build();
+
+    for (double cellSize : { 0.0, 0.5, 2.0 })
+    {
+        Grid3Index grid(view, cellSize);
+        grid.build(4);
+        if (cellSize)
+            EXPECT_DOUBLE_EQ(grid.cellSize(), cellSize);
+        else
+            EXPECT_GT(grid.cellSize(), 0.0);
+
+        compare(kd.knnAll(10), grid.knnAll(10, 4));
+        compare(kd.radiusAll(0.6), grid.radiusAll(0.6, 1));
+
+        for (PointId i = 0; i < view.size(); i += 101)
+        {
+            double x = view.getFieldAs<double>(Dimension::Id::X, i);
+            double y = view.getFieldAs<double>(Dimension::Id::Y, i);
+            double z = view.getFieldAs<double>(Dimension::Id::Z, i);
+            EXPECT_EQ(grid.neighbor(x, y, z), i);
+            EXPECT_EQ(kd.radius(x, y, z, 1.5).size(),
+                grid.radius(x, y, z, 1.5).size());
+        }
+
+        // Queries outside the points.
+        EXPECT_EQ(kd.neighbors(-50, 400, 20, 5),
+            grid.neighbors(-50, 400, 20, 5));
+        EXPECT_TRUE(grid.radius(-50, 400, 20, 1).empty());
+        EXPECT_EQ(grid.neighbors(5, 5, 5, 5000).size(), view.size());
+    }
+}
+
+TEST(GridIndex, matchesKD2)
+{
+    PointTable table;
+    PointView view(table);
+    makePoints(view, 2000);
+
+    KD2Index kd(view);
+    kd.build();
+    Grid2Index grid(view, 1.0);
+    grid.build();
+
+    compare(kd.knnAll(6), grid.knnAll(6));
+    compare(kd.radiusAll(1.0), grid.radiusAll(1.0));
+    EXPECT_EQ(kd.neighbor(1000, -1000), grid.neighbor(1000, -1000));
+}
+
+TEST(GridIndex, empty)
+{
+    PointTable table;
+    PointView view(table);
+    makePoints(view, 0);
+
+    Grid3Index grid(view, 1.0);
+    grid.build();
+    EXPECT_TRUE(grid.neighbors(0, 0, 0, 3).empty());
+    EXPECT_TRUE(grid.radius(0, 0, 0, 10).empty());
+    EXPECT_EQ(grid.knnAll(3).size(), 0u);
+}
+
+TEST(GridIndex, indexType)
+{
+    EXPECT_EQ(parseIndexType("filters.test", "kdtree"), IndexType::KDTree);
+    EXPECT_EQ(parseIndexType("filters.test", "Grid"), IndexType::Grid);
+    EXPECT_THROW(parseIndexType("filters.test", "octree"), pdal_error);
+}
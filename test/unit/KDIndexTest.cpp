@@ -288,3 +288,119 @@ TEST(KDIndex, radius3D)
     EXPECT_EQ(ids[4], 4u);
 }
 
+
+// Bulk queries on several threads must match the single point queries.
+TEST(KDIndex, bulk)
+{
+    PointTable table;
+    PointLayoutPtr layout = table.layout();
+    PointView view(table);
+
+    layout->registerDim(Dimension::Id::X);
+    layout->registerDim(Dimension::Id::Y);
+    layout->registerDim(Dimension::Id::Z);
+
+    // Points on a jittered grid so no two neighbors are equidistant.
+    for (PointId i = 0; i < 1000; ++i)
+    {
+        view.setField(Dimension::Id::X, i, (i % 10) + i * .0001);
+        view.setField(Dimension::Id::Y, i, ((i / 10) % 10) + i * .0002);
+        view.setField(Dimension::Id::Z, i, (i / 100) + i * .0003);
+    }
+
+    KD3Index index(view);
+    index.build();
+
+    for (std::size_t threads : { 1, 4 })
+    {
+        NeighborTable knn = index.knnAll(6, threads);
+        EXPECT_EQ(knn.size(), view.size());
+        NeighborTable rad = index.radiusAll(1.5, threads);
+        EXPECT_EQ(rad.size(), view.size());
+        for (PointId i = 0; i < view.size(); ++i)
+        {
+            double x = view.getFieldAs<double>(Dimension::Id::X, i);
+            double y = view.getFieldAs<double>(Dimension::Id::Y, i);
+            double z = view.getFieldAs<double>(Dimension::Id::Z, i);
+
+            std::vector<PointId> ids = index.neighbors(x, y, z, 6);
+            ColumnSpan<const PointId> bulk = knn.neighbors(i);
+            ASSERT_EQ(bulk.size(), ids.size());
+            EXPECT_EQ(bulk[0], i);
+            EXPECT_TRUE(std::equal(ids.begin(), ids.end(), bulk.begin()));
+
+            ids = index.radius(x, y, z, 1.5);
+            bulk = rad.neighbors(i);
+            ASSERT_EQ(bulk.size(), ids.size());
+            EXPECT_TRUE(std::equal(ids.begin(), ids.end(), bulk.begin()));
+            for (double d : rad.sqrDistances(i))
+                EXPECT_LE(d, 1.5 * 1.5);
+        }
+    }
+
+    KD2Index index2(view);
+    index2.build();
+    NeighborTable knn2 = index2.knn(view, 2000, 3);
+    EXPECT_EQ(knn2.neighbors(17).size(), view.size());
+    EXPECT_EQ(knn2.neighbors(17)[0], 17u);
+}
+
+TEST(KDIndex, parallelBuild)
+{
+    PointTable table;
+    PointLayoutPtr layout = table.layout();
+    PointView view(table);
+
+    layout->registerDim(Dimension::Id::X);
+    layout->registerDim(Dimension::Id::Y);
+    layout->registerDim(Dimension::Id::Z);
+
+    // Pseudo-random points, clustered so the tree is unbalanced.
+    uint32_t seed = 12345;
+    auto next = [&seed]()
+    {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 8) / double(1 << 24);
+    };
+    for (PointId i = 0; i < 5000; ++i)
+    {
+        double scale = (i % 3) ? 1.0 : 100.0;
+        view.setField(Dimension::Id::X, i, next() * scale);
+        view.setField(Dimension::Id::Y, i, next() * scale);
+        view.setField(Dimension::Id::Z, i, next() * scale);
+    }
+
+    KD3Index serial(view);
+    serial.build();
+
+    for (bool cache : { false, true })
+    {
+        KD3Index index(view);
+        index.build(4, cache);
+
+        NeighborTable expected = serial.knnAll(8);
+        NeighborTable knn = index.knnAll(8, 4);
+        EXPECT_EQ(expected.ids, knn.ids);
+        EXPECT_EQ(expected.sqrDists, knn.sqrDists);
+
+        expected = serial.radiusAll(0.2);
+        NeighborTable rad = index.radiusAll(0.2, 4);
+        EXPECT_EQ(expected.offsets, rad.offsets);
+        EXPECT_EQ(expected.ids, rad.ids);
+
+        for (PointId i = 0; i < view.size(); i += 97)
+        {
+            double x = view.getFieldAs<double>(Dimension::Id::X, i);
+            double y = view.getFieldAs<double>(Dimension::Id::Y, i);
+            double z = view.getFieldAs<double>(Dimension::Id::Z, i);
+            EXPECT_EQ(serial.neighbors(x, y, z, 5),
+                index.neighbors(x, y, z, 5));
+        }
+    }
+
+    KD2Index index2(view);
+    index2.build(0, true);
+    PointId id = index2.neighbor(view.getFieldAs<double>(Dimension::Id::X, 42),
+        view.getFieldAs<double>(Dimension::Id::Y, 42));
+    EXPECT_EQ(id, 42u);
+}
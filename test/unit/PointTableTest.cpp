@@ -178,3 +178,57 @@ TEST(PointTable, userView)
     EXPECT_TRUE(called);
 }
 
+
+TEST(PointTable, columns)
+{
+    using namespace Dimension;
+
+    LasReader reader;
+
+    Options opts;
+    opts.add("filename", Support::datapath("las/simple.las"));
+    reader.setOptions(opts);
+
+    PointTable rowTable;
+    reader.prepare(rowTable);
+    PointViewPtr rowView = *reader.execute(rowTable).begin();
+
+    ColumnPointTable colTable;
+    reader.prepare(colTable);
+    PointViewPtr colView = *reader.execute(colTable).begin();
+
+    ASSERT_EQ(rowView->size(), colView->size());
+    for (PointId idx = 0; idx < rowView->size(); ++idx)
+        for (Id dim : rowView->dims())
+            EXPECT_EQ(rowView->getFieldAs<double>(dim, idx),
+                colView->getFieldAs<double>(dim, idx));
+
+    EXPECT_FALSE(rowView->hasColumn<double>(Id::X));
+    EXPECT_THROW(rowView->column<double>(Id::X), pdal_error);
+    EXPECT_TRUE(colView->hasColumn<double>(Id::X));
+    EXPECT_FALSE(colView->hasColumn<float>(Id::X));
+    EXPECT_THROW(colView->column<float>(Id::X), pdal_error);
+
+    // The view hasn't been reordered, so its values are in a single run.
+    std::vector<ColumnSpan<double>> xs = colView->column<double>(Id::X);
+    ASSERT_EQ(xs.size(), 1u);
+    ASSERT_EQ(xs[0].size(), colView->size());
+    for (PointId idx = 0; idx < colView->size(); ++idx)
+        EXPECT_EQ(xs[0][idx], rowView->getFieldAs<double>(Id::X, idx));
+
+    // A view of every other point has a run per point.
+    PointViewPtr sparse = colView->makeNew();
+    for (PointId idx = 0; idx < colView->size(); idx += 2)
+        sparse->appendPoint(*colView, idx);
+    auto sparseXs = sparse->column<double>(Id::X);
+    ASSERT_EQ(sparseXs.size(), sparse->size());
+    for (PointId idx = 0; idx < sparse->size(); ++idx)
+        EXPECT_EQ(sparseXs[idx][0],
+            rowView->getFieldAs<double>(Id::X, idx * 2));
+
+    BOX3D rowBounds;
+    BOX3D colBounds;
+    rowView->calculateBounds(rowBounds);
+    colView->calculateBounds(colBounds);
+    EXPECT_EQ(rowBounds, colBounds);
+}
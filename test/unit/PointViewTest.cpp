@@ -37,6 +37,7 @@
 #include <array>
 #include <random>
 
+#include <pdal/KDIndex.hpp>
 #include <pdal/PointView.hpp>
 #include <pdal/PointViewIter.hpp>
 #include <pdal/PDALUtils.hpp>
@@ -457,6 +458,191 @@ TEST(PointViewTest, issue1264)
     EXPECT_THROW(v.setField(foo, 0, d), pdal_error);
 }
 
+TEST(PointViewTest, bulkFields)
+{
+    using namespace Dimension;
+
+    auto check = [](BasePointTable& table)
+    {
+        const point_count_t cnt = 100;
+        PointViewPtr view = makeTestView(table, cnt);
+
+        // Read a whole dimension and a sub-range.
+        std::vector<double> xs(cnt);
+        view->getFieldsAs(Id::X, 0, cnt, xs.data());
+        for (PointId i = 0; i < cnt; ++i)
+            EXPECT_DOUBLE_EQ(xs[i], i * 10);
+        std::vector<int> ys(10);
+        view->getFieldsAs(Id::Y, 20, 30, ys.data());
+        for (PointId i = 0; i < 10; ++i)
+            EXPECT_EQ(ys[i], (i + 20) * 100);
+
+        // Points out of table order.
+        PointViewPtr rev = view->makeNew();
+        for (PointId i = cnt; i > 0; --i)
+            rev->appendPoint(*view, i - 1);
+        rev->getFieldsAs(Id::X, 0, cnt, xs.data());
+        for (PointId i = 0; i < cnt; ++i)
+            EXPECT_DOUBLE_EQ(xs[i], (cnt - i - 1) * 10);
+
+        // Set a range through the reordered view.
+        std::vector<double> vals { 1.2, 2.7, 3.0 };
+        rev->setFields(Id::X, 10, 13, vals.data());
+        EXPECT_EQ(rev->getFieldAs<int>(Id::X, 10), 1);
+        EXPECT_EQ(rev->getFieldAs<int>(Id::X, 11), 3);
+        EXPECT_EQ(rev->getFieldAs<int>(Id::X, 12), 3);
+        EXPECT_EQ(view->getFieldAs<int>(Id::X, cnt - 11), 1);
+
+        // Values that don't fit the requested type.
+        std::vector<uint8_t> small(cnt);
+        EXPECT_THROW(view->getFieldsAs(Id::Y, 0, cnt, small.data()),
+            pdal_error);
+        std::vector<double> big { 1000.0 };
+        EXPECT_THROW(view->setFields(Id::Classification, 0, 1, big.data()),
+            pdal_error);
+    };
+
+    PointTable table;
+    check(table);
+    ColumnPointTable colTable;
+    check(colTable);
+}
+
+TEST(PointViewTest, idList)
+{
+    using namespace Dimension;
+
+    PointTable table;
+    PointViewPtr view = makeTestView(table, 100);
+
+    // A subset of adjacent points followed by a point out of order.
+    PointViewPtr subset = view->makeNew();
+    for (PointId i = 10; i < 20; ++i)
+        subset->appendPoint(*view, i);
+    EXPECT_EQ(subset->getFieldAs<int>(Id::X, 0), 100);
+    EXPECT_EQ(subset->getFieldAs<int>(Id::X, 9), 190);
+    subset->appendPoint(*view, 5);
+    EXPECT_EQ(subset->size(), 11u);
+    EXPECT_EQ(subset->getFieldAs<int>(Id::X, 9), 190);
+    EXPECT_EQ(subset->getFieldAs<int>(Id::X, 10), 50);
+
+    // Appending views that continue the range and views that don't.
+    PointViewPtr all = view->makeNew();
+    all->append(*view);
+    all->append(*subset);
+    EXPECT_EQ(all->size(), 111u);
+    EXPECT_EQ(all->getFieldAs<int>(Id::X, 99), 990);
+    EXPECT_EQ(all->getFieldAs<int>(Id::X, 100), 100);
+    EXPECT_EQ(all->getFieldAs<int>(Id::X, 110), 50);
+
+    // Reorder.
+    auto cmp = [](const PointIdxRef& p1, const PointIdxRef& p2)
+        { return p2.compare(Id::X, p1); };
+    std::sort(view->begin(), view->end(), cmp);
+    for (PointId i = 0; i < view->size(); ++i)
+        EXPECT_EQ(view->getFieldAs<int>(Id::X, i), (99 - i) * 10);
+}
+
+TEST(PointViewTest, tablePoint)
+{
+    using namespace Dimension;
+
+    PointTable table;
+    PointViewPtr view = makeTestView(table, 100);
+    PointViewPtr subset = view->makeNew();
+    for (PointId i = 50; i > 0; --i)
+        subset->appendPoint(*view, i);
+
+    // Writes go to the point the view refers to and leave the index.
+    KD2Index& index = subset->build2dIndex();
+    PointRef point = subset->tablePoint(10);
+    point.setField(Id::X, 12345);
+    EXPECT_EQ(subset->getFieldAs<int>(Id::X, 10), 12345);
+    EXPECT_EQ(view->getFieldAs<int>(Id::X, 40), 12345);
+    EXPECT_EQ(&index, &subset->build2dIndex());
+}
+
+TEST(PointViewTest, spatialIndex)
+{
+    using namespace Dimension;
+
+    PointTable table;
+    PointLayoutPtr layout(table.layout());
+    layout->registerDim(Id::X);
+    layout->registerDim(Id::Y);
+    layout->registerDim(Id::Z);
+    layout->registerDim(Id::Intensity);
+
+    PointView view(table);
+    for (PointId i = 0; i < 100; ++i)
+    {
+        view.setField(Id::X, i, i);
+        view.setField(Id::Y, i, i);
+        view.setField(Id::Z, i, i);
+    }
+
+    // The same index is returned until the points change.
+    KD3Index& index3 = view.build3dIndex();
+    KD2Index& index2 = view.build2dIndex(2);
+    EXPECT_EQ(&index3, &view.build3dIndex());
+    EXPECT_EQ(index3.neighbor(50, 50, 50), 50u);
+    EXPECT_EQ(index2.neighbor(50, 50), 50u);
+
+    // Writing other dimensions keeps the index.
+    view.setField(Id::Intensity, 10, 5);
+    EXPECT_EQ(&index2, &view.build2dIndex());
+
+    // Writing Z discards the 3D index only.
+    view.setField(Id::Z, 50, 1000);
+    EXPECT_EQ(&index2, &view.build2dIndex());
+    EXPECT_EQ(view.build3dIndex().neighbor(50, 50, 49.4), 49u);
+
+    // Bulk writes of X discard both.
+    std::vector<double> xs(100, 500.0);
+    view.setFields(Id::X, 0, 50, xs.data());
+    EXPECT_EQ(view.build2dIndex().neighbor(40, 40), 50u);
+
+    // Reordering the view discards the index.
+    std::reverse(view.begin(), view.end());
+    EXPECT_EQ(view.build2dIndex().neighbor(60, 60), 39u);
+
+    // Appended points are found.
+    view.setField(Id::X, 100, 1000);
+    view.setField(Id::Y, 100, 1000);
+    view.setField(Id::Z, 100, 1000);
+    EXPECT_EQ(view.build2dIndex().neighbor(990, 990), 100u);
+
+    // Copies of a view don't share its index.
+    PointView copy(view);
+    EXPECT_NE(&copy.build3dIndex(), &view.build3dIndex());
+
+    // Writing X through columns discards the index.
+    ColumnPointTable colTable;
+    PointLayoutPtr colLayout(colTable.layout());
+    colLayout->registerDim(Id::X);
+    colLayout->registerDim(Id::Y);
+    colLayout->registerDim(Id::Z);
+
+    PointView colView(colTable);
+    for (PointId i = 0; i < 100; ++i)
+    {
+        colView.setField(Id::X, i, i);
+        colView.setField(Id::Y, i, i);
+        colView.setField(Id::Z, i, i);
+    }
+    EXPECT_EQ(colView.build2dIndex().neighbor(20, 20), 20u);
+    for (auto& span : colView.column<double>(Id::X))
+        for (std::size_t i = 0; i < span.size(); ++i)
+            span.data()[i] += 10;
+    EXPECT_EQ(colView.build2dIndex().neighbor(20, 20), 15u);
+
+    // Reading columns of a const view keeps it.
+    KD2Index& colIndex = colView.build2dIndex();
+    const PointView& constView(colView);
+    constView.column<double>(Id::X);
+    EXPECT_EQ(&colIndex, &colView.build2dIndex());
+}
+
 // Per discussions with @abellgithub (https://github.com/gadomski/PDAL/commit/c1d54e56e2de841d37f2a1b1c218ed723053f6a9#commitcomment-14415138)
 // we only do bounds checking on `PointView`s when in debug mode.
 #ifndef NDEBUG
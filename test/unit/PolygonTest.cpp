@@ -41,6 +41,7 @@
 #include <pdal/Options.hpp>
 
 #include <pdal/Polygon.hpp>
+#include <pdal/PolygonIndex.hpp>
 #include "Support.hpp"
 
 
@@ -142,6 +143,82 @@ TEST(PolygonTest, covers)
     EXPECT_EQ(covered, true);
 }
 
+TEST(PolygonTest, index)
+{
+    using namespace pdal::Dimension;
+
+    pdal::Polygon p(getWKT());
+    PolygonIndex index(p);
+    BOX3D b = p.bounds();
+
+    PointTable table;
+    PointLayoutPtr layout(table.layout());
+    layout->registerDim(Dimension::Id::X);
+    layout->registerDim(Dimension::Id::Y);
+    PointViewPtr view(new PointView(table));
+
+    // Random points in and around the polygon's bounds.
+    uint32_t seed = 5;
+    const double width = b.maxx - b.minx;
+    const double height = b.maxy - b.miny;
+    for (PointId i = 0; i < 5000; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        double x = b.minx - width / 10 + (seed >> 8) % 10000 * width / 8000;
+        seed = seed * 1103515245 + 12345;
+        double y = b.miny - height / 10 + (seed >> 8) % 10000 * height / 8000;
+        view->setField(Id::X, i, x);
+        view->setField(Id::Y, i, y);
+    }
+
+    pdal::PointRef ref(*view, 0);
+    for (PointId i = 0; i < view->size(); ++i)
+    {
+        ref.setPointId(i);
+        double x = view->getFieldAs<double>(Id::X, i);
+        double y = view->getFieldAs<double>(Id::Y, i);
+        EXPECT_EQ(index.covers(x, y), p.covers(ref)) << x << ", " << y;
+    }
+
+    // The first point of the polygon lies on its boundary.
+    EXPECT_TRUE(index.covers(636889.412951239268295, 851528.512293258565478));
+}
+
+TEST(PolygonTest, indexRings)
+{
+    std::vector<PolygonIndex::Ring> rings;
+
+    // A square with a square hole, and an island in the hole.
+    rings.push_back({ {0, 0}, {10, 0}, {10, 10}, {0, 10}, {0, 0} });
+    rings.push_back({ {2, 2}, {8, 2}, {8, 8}, {2, 8} });
+    rings.push_back({ {4, 4}, {6, 4}, {6, 6}, {4, 6} });
+    PolygonIndex index(rings);
+
+    EXPECT_TRUE(index.covers(1, 1));
+    EXPECT_FALSE(index.covers(3, 3));
+    EXPECT_TRUE(index.covers(5, 5));
+    EXPECT_FALSE(index.covers(11, 5));
+    EXPECT_FALSE(index.covers(-1, 5));
+
+    // Points on the boundary are covered.
+    EXPECT_TRUE(index.covers(0, 5));
+    EXPECT_TRUE(index.covers(10, 10));
+    EXPECT_TRUE(index.covers(2, 5));
+    EXPECT_TRUE(index.covers(6, 6));
+
+    double x[] = { 1, 3, 5, 20 };
+    double y[] = { 1, 3, 5, 20 };
+    uint8_t covered[4];
+    index.covers(x, y, 4, covered);
+    EXPECT_EQ(covered[0], 1);
+    EXPECT_EQ(covered[1], 0);
+    EXPECT_EQ(covered[2], 1);
+    EXPECT_EQ(covered[3], 0);
+
+    PolygonIndex empty((std::vector<PolygonIndex::Ring>()));
+    EXPECT_FALSE(empty.covers(0, 0));
+}
+
 TEST(PolygonTest, valid)
 {
     pdal::Polygon p(getWKT());
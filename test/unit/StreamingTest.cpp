@@ -34,10 +34,15 @@
 
 #include <pdal/pdal_test_main.hpp>
 
+#include <chrono>
+#include <cstdlib>
+#include <future>
+
 #include <pdal/Filter.hpp>
 #include <pdal/PointTable.hpp>
 #include <FauxReader.hpp>
 #include <MergeFilter.hpp>
+#include <SortFilter.hpp>
 #include <StreamCallbackFilter.hpp>
 #include "Support.hpp"
 
@@ -106,3 +111,112 @@ TEST(Streaming, filter)
     f.execute(t);
     EXPECT_EQ(cnt, 400);
 }
+
+// Run reader, filter and callback on their own threads and make sure
+// the points still come out in order.
+TEST(Streaming, pipelined)
+{
+    Options ro;
+    ro.add("bounds", BOX3D(0, 0, 0, 999, 999, 999));
+    ro.add("mode", "ramp");
+    ro.add("count", 1000);
+    FauxReader r;
+    r.setOptions(ro);
+
+    MergeFilter m;
+    m.setInput(r);
+
+    StreamCallbackFilter f;
+    int cnt = 0;
+    auto cb = [&cnt](PointRef& point)
+    {
+        EXPECT_EQ(point.getFieldAs<int>(Dimension::Id::X), cnt);
+        EXPECT_EQ(point.getFieldAs<int>(Dimension::Id::Y), cnt);
+        EXPECT_EQ(point.getFieldAs<int>(Dimension::Id::Z), cnt);
+        cnt++;
+        return true;
+    };
+    f.setCallback(cb);
+    f.setInput(m);
+
+    Options fo;
+    fo.add("pipeline_threads", 3);
+    f.setOptions(fo);
+
+    FixedPointTable t(64);
+    f.prepare(t);
+    f.execute(t);
+    EXPECT_EQ(cnt, 1000);
+}
+
+// Make sure an exception thrown by any stage of a pipelined run reaches
+// the caller and that none of the other threads is left waiting.
+TEST(Streaming, pipelinedThrow)
+{
+    for (int thrower = 0; thrower < 2; ++thrower)
+    {
+        Options ro;
+        ro.add("bounds", BOX3D(0, 0, 0, 9999, 9999, 9999));
+        ro.add("mode", "ramp");
+        ro.add("count", 10000);
+        FauxReader r;
+        r.setOptions(ro);
+
+        int cnt1 = 0;
+        StreamCallbackFilter f1;
+        f1.setCallback([&cnt1, thrower](PointRef&)
+        {
+            if (thrower == 0 && ++cnt1 == 500)
+                throw pdal_error("Middle stage failed.");
+            return true;
+        });
+        f1.setInput(r);
+
+        int cnt2 = 0;
+        StreamCallbackFilter f2;
+        f2.setCallback([&cnt2, thrower](PointRef&)
+        {
+            if (thrower == 1 && ++cnt2 == 500)
+                throw pdal_error("Last stage failed.");
+            return true;
+        });
+        f2.setInput(f1);
+
+        Options fo;
+        fo.add("pipeline_threads", 3);
+        f2.setOptions(fo);
+
+        FixedPointTable t(64);
+        f2.prepare(t);
+
+        // A deadlocked thread would keep execute() from ever returning.
+        auto result = std::async(std::launch::async, [&f2, &t]()
+            { f2.execute(t); });
+        if (result.wait_for(std::chrono::seconds(60)) !=
+            std::future_status::ready)
+        {
+            ADD_FAILURE() << "Pipelined execution didn't finish.";
+            std::abort();
+        }
+        EXPECT_THROW(result.get(), pdal_error);
+    }
+}
+
+TEST(Streaming, pipelineStreamable)
+{
+    FauxReader r;
+    MergeFilter m;
+    m.setInput(r);
+    StreamCallbackFilter f;
+    f.setInput(m);
+    EXPECT_TRUE(f.pipelineStreamable());
+
+    // A stage that can't stream anywhere in the pipeline prevents
+    // streaming.
+    SortFilter s;
+    s.setInput(r);
+    StreamCallbackFilter f2;
+    f2.setInput(s);
+    EXPECT_FALSE(s.pipelineStreamable());
+    EXPECT_FALSE(f2.pipelineStreamable());
+}
@@ -37,7 +37,9 @@
 #include <LasReader.hpp>
 #include <ColorizationFilter.hpp>
 #include <StreamCallbackFilter.hpp>
+#include <pdal/GDALUtils.hpp>
 #include <pdal/PointView.hpp>
+#include <pdal/util/FileUtils.hpp>
 
 #include "Support.hpp"
 
@@ -188,3 +190,88 @@ TEST(ColorizationFilterTest, test4)
 }
 
 
+
+// Interpolated values lie between those of the surrounding pixels and
+// a tiny cache still gives the same result as the default.
+TEST(ColorizationFilterTest, bilinear)
+{
+    Options options;
+
+    options.add("raster", Support::datapath("autzen/autzen.jpg"));
+    options.add("cache_size", .001);
+
+    StringList dims;
+    dims.push_back("Red");
+    dims.push_back("Green");
+    dims.push_back("Blue");
+    testFile(options, dims, 210, 205, 185);
+
+    gdal::registerDrivers();
+    gdal::Raster raster(Support::datapath("autzen/autzen.jpg"));
+    raster.open();
+
+    // Center of the pixel at column 10, row 20, and the point halfway to
+    // the next pixel center in X.
+    std::array<double, 2> c0;
+    std::array<double, 2> c1;
+    raster.pixelToCoord(10, 20, c0);
+    raster.pixelToCoord(11, 20, c1);
+    std::vector<double> x { c0[0], c1[0], (c0[0] + c1[0]) / 2 };
+    std::vector<double> y { c0[1], c1[1], (c0[1] + c1[1]) / 2 };
+
+    std::vector<double> data;
+    std::vector<uint8_t> valid;
+    EXPECT_EQ(raster.read(x.data(), y.data(), 3, data, valid, true),
+        gdal::GDALError::None);
+    int bands = raster.m_band_count;
+    for (int b = 0; b < bands; ++b)
+        EXPECT_NEAR(data[2 * bands + b], (data[b] + data[bands + b]) / 2,
+            1e-6);
+    EXPECT_EQ(valid, std::vector<uint8_t>(3, 1));
+
+    std::vector<double> outside { -1e10 };
+    EXPECT_EQ(raster.read(outside.data(), outside.data(), 1, data, valid),
+        gdal::GDALError::None);
+    EXPECT_EQ(valid[0], 0);
+}
+
+// Bilinear reads don't mix nodata pixels into the interpolated value.
+TEST(ColorizationFilterTest, bilinearNoData)
+{
+    gdal::registerDrivers();
+    std::string filename(Support::temppath("bilinear_nodata.tif"));
+    FileUtils::deleteFile(filename);
+
+    // A 2x2 raster with pixel centers at (.5, 1.5), (1.5, 1.5), (.5, .5)
+    // and (1.5, .5).  The last pixel is nodata.
+    GDALDriverH driver = GDALGetDriverByName("GTiff");
+    GDALDatasetH ds = GDALCreate(driver, filename.c_str(), 2, 2, 1,
+        GDT_Float64, NULL);
+    double transform[] = { 0, 1, 0, 2, 0, -1 };
+    GDALSetGeoTransform(ds, transform);
+    GDALRasterBandH band = GDALGetRasterBand(ds, 1);
+    GDALSetRasterNoDataValue(band, -9999);
+    double values[] = { 10, 20, 30, -9999 };
+    EXPECT_EQ(GDALRasterIO(band, GF_Write, 0, 0, 2, 2, values, 2, 2,
+        GDT_Float64, 0, 0), CE_None);
+    GDALClose(ds);
+
+    gdal::Raster raster(filename);
+    raster.open();
+
+    // Halfway between the two valid pixel centers of the first row, near
+    // the center of the first pixel and inside the nodata pixel.
+    std::vector<double> x { 1, .75, 1.25 };
+    std::vector<double> y { 1.5, 1.25, .75 };
+    std::vector<double> data;
+    std::vector<uint8_t> valid;
+    EXPECT_EQ(raster.read(x.data(), y.data(), 3, data, valid, true),
+        gdal::GDALError::None);
+    EXPECT_EQ(valid, std::vector<uint8_t>(3, 1));
+    EXPECT_DOUBLE_EQ(data[0], 15);
+    EXPECT_DOUBLE_EQ(data[1], 10);
+    EXPECT_DOUBLE_EQ(data[2], -9999);
+
+    raster.close();
+    FileUtils::deleteFile(filename);
+}
@@ -46,6 +46,8 @@
 #include <StreamCallbackFilter.hpp>
 #include "Support.hpp"
 
+#include <sstream>
+
 using namespace pdal;
 
 TEST(CropFilterTest, create)
@@ -258,6 +260,68 @@ TEST(CropFilterTest, multibounds)
     EXPECT_EQ(total_cnt, 7);
 }
 
+TEST(CropFilterTest, manyPolygons)
+{
+    using namespace Dimension;
+
+    PointTable table;
+    table.layout()->registerDim(Id::X);
+    table.layout()->registerDim(Id::Y);
+    table.layout()->registerDim(Id::Z);
+
+    // A point at the center of each unit cell of a 20x20 grid.
+    PointViewPtr view(new PointView(table));
+    PointId id = 0;
+    for (int i = 0; i < 20; ++i)
+        for (int j = 0; j < 20; ++j)
+        {
+            view->setField(Id::X, id, i + .5);
+            view->setField(Id::Y, id, j + .5);
+            id++;
+        }
+
+    // Squares of two by two cells, overlapping their neighbors by a cell,
+    // and a box over the whole grid.
+    Options o;
+    for (int i = 0; i < 19; ++i)
+        for (int j = 0; j < 19; j += 3)
+        {
+            std::ostringstream oss;
+            oss << "POLYGON ((" << i << " " << j << ", " << i + 2 << " " <<
+                j << ", " << i + 2 << " " << j + 2 << ", " << i << " " <<
+                j + 2 << ", " << i << " " << j << "))";
+            o.add("polygon", oss.str());
+        }
+    o.add("bounds", "([0, 20], [0, 20])");
+
+    for (bool outside : { false, true })
+    {
+        Options opts(o);
+        opts.add("outside", outside);
+
+        BufferReader r;
+        r.addView(view);
+        CropFilter crop;
+        crop.setInput(r);
+        crop.setOptions(opts);
+        crop.prepare(table);
+        PointViewSet s = crop.execute(table);
+
+        // One view for each polygon (19 x 7), then the box.
+        ASSERT_EQ(s.size(), 134u);
+        point_count_t total = 0;
+        for (auto v : s)
+        {
+            if (v == *s.rbegin())
+                EXPECT_EQ(v->size(), outside ? 0u : 400u);
+            else
+                EXPECT_EQ(v->size(), outside ? 396u : 4u);
+            total += v->size();
+        }
+        EXPECT_EQ(total, outside ? 133u * 396 : 133u * 4 + 400);
+    }
+}
+
 TEST(CropFilterTest, stream)
 {
     using namespace Dimension;
@@ -0,0 +1,135 @@
+/******************************************************************************
+* Copyright (c) 2016, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <pdal/PointView.hpp>
+#include <pdal/StageFactory.hpp>
+#include <BufferReader.hpp>
+#include <OutlierFilter.hpp>
+
+using namespace pdal;
+
+namespace
+{
+
+// A 10 x 10 grid of points one unit apart, followed by three points far
+// from it and from each other.
+PointViewPtr makeView(PointTableRef table)
+{
+    using namespace Dimension;
+
+    table.layout()->registerDim(Id::X);
+    table.layout()->registerDim(Id::Y);
+    table.layout()->registerDim(Id::Z);
+    table.layout()->registerDim(Id::Classification);
+    PointViewPtr view(new PointView(table));
+
+    PointId idx = 0;
+    for (int i = 0; i < 10; ++i)
+        for (int j = 0; j < 10; ++j)
+        {
+            view->setField(Id::X, idx, i);
+            view->setField(Id::Y, idx, j);
+            view->setField(Id::Z, idx, 0);
+            idx++;
+        }
+    for (Id dim : { Id::X, Id::Y, Id::Z })
+    {
+        view->setField(Id::X, idx, 0);
+        view->setField(Id::Y, idx, 0);
+        view->setField(Id::Z, idx, 0);
+        view->setField(dim, idx, 100);
+        idx++;
+    }
+    return view;
+}
+
+} // unnamed namespace
+
+TEST(OutlierFilterTest, create)
+{
+    StageFactory f;
+    Stage* filter(f.createStage("filters.outlier"));
+    EXPECT_TRUE(filter);
+}
+
+TEST(OutlierFilterTest, classify)
+{
+    for (std::string method : { "statistical", "radius" })
+    {
+        PointTable table;
+        BufferReader r;
+        r.addView(makeView(table));
+
+        Options opts;
+        opts.add("method", method);
+        opts.add("radius", 1.1);
+        OutlierFilter filter;
+        filter.setOptions(opts);
+        filter.setInput(r);
+        filter.prepare(table);
+        PointViewSet viewSet = filter.execute(table);
+        EXPECT_EQ(viewSet.size(), 1u);
+        PointViewPtr view = *viewSet.begin();
+        EXPECT_EQ(view->size(), 103u);
+
+        for (PointId i = 0; i < view->size(); ++i)
+            EXPECT_EQ(view->getFieldAs<int>(Dimension::Id::Classification, i),
+                i < 100 ? 0 : 18);
+    }
+}
+
+TEST(OutlierFilterTest, extract)
+{
+    PointTable table;
+    BufferReader r;
+    r.addView(makeView(table));
+
+    Options opts;
+    opts.add("method", "radius");
+    opts.add("radius", 1.1);
+    opts.add("extract", true);
+    opts.add("index", "grid");
+    OutlierFilter filter;
+    filter.setOptions(opts);
+    filter.setInput(r);
+    filter.prepare(table);
+    PointViewSet viewSet = filter.execute(table);
+    EXPECT_EQ(viewSet.size(), 1u);
+    PointViewPtr view = *viewSet.begin();
+    EXPECT_EQ(view->size(), 100u);
+    for (PointId i = 0; i < view->size(); ++i)
+        EXPECT_LT(view->getFieldAs<double>(Dimension::Id::X, i), 10);
+}
@@ -0,0 +1,98 @@
+/******************************************************************************
+* Copyright (c) 2016, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <pdal/PointView.hpp>
+#include <pdal/StageFactory.hpp>
+#include <BufferReader.hpp>
+#include <PMFFilter.hpp>
+
+using namespace pdal;
+
+TEST(PMFFilterTest, create)
+{
+    StageFactory f;
+    Stage* filter(f.createStage("filters.pmf"));
+    EXPECT_TRUE(filter);
+}
+
+// A flat 20 x 20 grid of points with a raised 3 x 3 block in the middle.
+// Everything but the block is ground, with either algorithm.
+TEST(PMFFilterTest, extract)
+{
+    using namespace Dimension;
+
+    for (bool approximate : { false, true })
+    {
+        PointTable table;
+        table.layout()->registerDim(Id::X);
+        table.layout()->registerDim(Id::Y);
+        table.layout()->registerDim(Id::Z);
+        table.layout()->registerDim(Id::Classification);
+        PointViewPtr input(new PointView(table));
+
+        PointId idx = 0;
+        for (int i = 0; i < 20; ++i)
+            for (int j = 0; j < 20; ++j)
+            {
+                bool block = (i >= 9 && i < 12 && j >= 9 && j < 12);
+                input->setField(Id::X, idx, i);
+                input->setField(Id::Y, idx, j);
+                input->setField(Id::Z, idx, block ? 5 : 0);
+                idx++;
+            }
+
+        BufferReader r;
+        r.addView(input);
+
+        Options opts;
+        opts.add("max_window_size", 12);
+        opts.add("extract", true);
+        opts.add("approximate", approximate);
+        PMFFilter filter;
+        filter.setOptions(opts);
+        filter.setInput(r);
+        filter.prepare(table);
+        PointViewSet viewSet = filter.execute(table);
+        EXPECT_EQ(viewSet.size(), 1u);
+        PointViewPtr view = *viewSet.begin();
+        EXPECT_EQ(view->size(), 391u);
+        for (PointId i = 0; i < view->size(); ++i)
+        {
+            EXPECT_EQ(view->getFieldAs<double>(Id::Z, i), 0);
+            EXPECT_EQ(view->getFieldAs<int>(Id::Classification, i), 2);
+        }
+    }
+}
@@ -54,6 +54,26 @@ void getPoint(const PointView& data, double& x, double& y, double& z)
     y = data.getFieldAs<double>(Dimension::Id::Y, 0);
     z = data.getFieldAs<double>(Dimension::Id::Z, 0);
 }
+
+// Reproject autzen_trim.las to EPSG:4326 with additional filter options.
+PointViewPtr reprojectAutzen(PointTableRef table, Options options)
+{
+    Options ops1;
+    ops1.add("filename", Support::datapath("las/autzen_trim.las"));
+    LasReader reader;
+    reader.setOptions(ops1);
+
+    options.add("out_srs", "EPSG:4326");
+
+    ReprojectionFilter reprojectionFilter;
+    reprojectionFilter.setOptions(options);
+    reprojectionFilter.setInput(reader);
+
+    reprojectionFilter.prepare(table);
+    PointViewSet viewSet = reprojectionFilter.execute(table);
+    EXPECT_EQ(viewSet.size(), 1u);
+    return *viewSet.begin();
+}
 #endif
 
 } // unnamed namespace
@@ -148,3 +168,75 @@ TEST(ReprojectionFilterTest, stream_test_1)
 }
 #endif
 
+
+#if defined(PDAL_HAVE_LIBGEOTIFF)
+// Splitting the points among threads must not change the result.
+TEST(ReprojectionFilterTest, threads)
+{
+    Options ops1;
+    ops1.add("threads", 1);
+    PointTable t1;
+    PointViewPtr v1 = reprojectAutzen(t1, ops1);
+
+    Options ops4;
+    ops4.add("threads", 4);
+    PointTable t4;
+    PointViewPtr v4 = reprojectAutzen(t4, ops4);
+
+    ASSERT_EQ(v1->size(), v4->size());
+    ASSERT_GT(v1->size(), 0u);
+    for (PointId i = 0; i < v1->size(); ++i)
+    {
+        EXPECT_EQ(v1->getFieldAs<double>(Dimension::Id::X, i),
+            v4->getFieldAs<double>(Dimension::Id::X, i));
+        EXPECT_EQ(v1->getFieldAs<double>(Dimension::Id::Y, i),
+            v4->getFieldAs<double>(Dimension::Id::Y, i));
+        EXPECT_EQ(v1->getFieldAs<double>(Dimension::Id::Z, i),
+            v4->getFieldAs<double>(Dimension::Id::Z, i));
+    }
+    EXPECT_NEAR(v1->getFieldAs<double>(Dimension::Id::X, 0), -123.07, .1);
+    EXPECT_NEAR(v1->getFieldAs<double>(Dimension::Id::Y, 0), 44.05, .1);
+}
+#endif
+
+#if defined(PDAL_HAVE_LIBGEOTIFF)
+// Interpolated coordinates must be close to exact ones.
+TEST(ReprojectionFilterTest, maxError)
+{
+    const double maxError = 1e-7;
+
+    PointTable exactTable;
+    PointViewPtr exact = reprojectAutzen(exactTable, Options());
+
+    Options options;
+    options.add("max_error", maxError);
+    PointTable approxTable;
+    PointViewPtr approx = reprojectAutzen(approxTable, options);
+    ASSERT_EQ(exact->size(), approx->size());
+    ASSERT_GT(exact->size(), 0u);
+
+    // The error is only checked at the corners of the grid twice as fine
+    // as the one used and at the middle Z.  Elsewhere the planar and
+    // vertical interpolation errors can add up, so allow twice the
+    // maximum error.
+    const double tolerance = 2 * maxError;
+    point_count_t interpolated = 0;
+    for (PointId i = 0; i < exact->size(); ++i)
+    {
+        double ex = exact->getFieldAs<double>(Dimension::Id::X, i);
+        double ey = exact->getFieldAs<double>(Dimension::Id::Y, i);
+        double ez = exact->getFieldAs<double>(Dimension::Id::Z, i);
+        double ax = approx->getFieldAs<double>(Dimension::Id::X, i);
+        double ay = approx->getFieldAs<double>(Dimension::Id::Y, i);
+        double az = approx->getFieldAs<double>(Dimension::Id::Z, i);
+        EXPECT_NEAR(ex, ax, tolerance);
+        EXPECT_NEAR(ey, ay, tolerance);
+        EXPECT_NEAR(ez, az, tolerance);
+        if (ex != ax || ey != ay || ez != az)
+            interpolated++;
+    }
+    // Exact transformation is used when the grid would be too large, so
+    // make sure the points were really interpolated.
+    EXPECT_GT(interpolated, 0u);
+}
+#endif
@@ -0,0 +1,101 @@
+/******************************************************************************
+* Copyright (c) 2016, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include <pdal/PointView.hpp>
+#include <pdal/StageFactory.hpp>
+#include <BufferReader.hpp>
+#include <SampleFilter.hpp>
+
+using namespace pdal;
+
+TEST(SampleFilterTest, create)
+{
+    StageFactory f;
+    Stage* filter(f.createStage("filters.sample"));
+    EXPECT_TRUE(filter);
+}
+
+// Sample pairs of nearly coincident points on a 20 x 20 lattice with a
+// radius that only covers a pair.  Whichever point of a pair is kept,
+// exactly one point remains at each lattice site.
+TEST(SampleFilterTest, pairs)
+{
+    using namespace Dimension;
+
+    PointTable table;
+    table.layout()->registerDim(Id::X);
+    table.layout()->registerDim(Id::Y);
+    table.layout()->registerDim(Id::Z);
+    table.layout()->registerDim(Id::Classification);
+    PointViewPtr input(new PointView(table));
+
+    PointId idx = 0;
+    for (int i = 0; i < 20; ++i)
+        for (int j = 0; j < 20; ++j)
+            for (int k = 0; k < 2; ++k)
+            {
+                input->setField(Id::X, idx, i + k * .01);
+                input->setField(Id::Y, idx, j + k * .01);
+                input->setField(Id::Z, idx, k * .01);
+                idx++;
+            }
+
+    BufferReader r;
+    r.addView(input);
+
+    Options opts;
+    opts.add("radius", .1);
+    SampleFilter filter;
+    filter.setOptions(opts);
+    filter.setInput(r);
+    filter.prepare(table);
+    PointViewSet viewSet = filter.execute(table);
+    EXPECT_EQ(viewSet.size(), 1u);
+    PointViewPtr view = *viewSet.begin();
+    EXPECT_EQ(view->size(), 400u);
+
+    std::vector<std::pair<double, double>> sites;
+    for (PointId i = 0; i < view->size(); ++i)
+        sites.emplace_back(std::round(view->getFieldAs<double>(Id::X, i)),
+            std::round(view->getFieldAs<double>(Id::Y, i)));
+    std::sort(sites.begin(), sites.end());
+    EXPECT_TRUE(std::unique(sites.begin(), sites.end()) == sites.end());
+}
@@ -34,14 +34,46 @@
 
 #include <pdal/pdal_test_main.hpp>
 
+#include <algorithm>
+#include <mutex>
+
+#include <pdal/Filter.hpp>
+#include <pdal/PointViewIter.hpp>
 #include <pdal/StageFactory.hpp>
 #include <pdal/StageWrapper.hpp>
+#include <FauxReader.hpp>
 #include <LasReader.hpp>
 #include <SplitterFilter.hpp>
 #include "Support.hpp"
 
 using namespace pdal;
 
+namespace
+{
+
+// Record the number of threads the filter may use for each view.
+class ThreadsFilter : public Filter
+{
+public:
+    std::string getName() const
+        { return "filters.threadstest"; }
+
+    std::vector<std::size_t> m_threads;
+
+private:
+    std::mutex m_mutex;
+
+    virtual bool parallelSafe() const
+        { return true; }
+    virtual void filter(PointView& /*view*/)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_threads.push_back(threads());
+    }
+};
+
+} // unnamed namespace
+
 TEST(SplitterTest, test_tile_filter)
 {
     StageFactory f;
@@ -101,3 +133,91 @@ TEST(SplitterTest, test_tile_filter)
         EXPECT_EQ(view->size(), counts[i]);
     }
 }
+
+// Run the split views through a filter on several threads and make sure
+// the output matches a synchronous run.
+TEST(SplitterTest, parallel)
+{
+    auto run = [](int threads)
+    {
+        StageFactory f;
+
+        Options ro;
+        ro.add("filename", Support::datapath("las/1.2-with-color.las"));
+        LasReader r;
+        r.setOptions(ro);
+
+        Options so;
+        so.add("length", 100);
+        SplitterFilter s;
+        s.setOptions(so);
+        s.setInput(r);
+
+        Stage *sort(f.createStage("filters.sort"));
+        Options fo;
+        fo.add("dimension", "Z");
+        fo.add("threads", threads);
+        sort->setOptions(fo);
+        sort->setInput(s);
+
+        PointTable table;
+        sort->prepare(table);
+        PointViewSet viewSet = sort->execute(table);
+
+        std::vector<double> zs;
+        for (auto& v : viewSet)
+        {
+            EXPECT_TRUE(std::is_sorted(v->begin(), v->end(),
+                [](const PointIdxRef& p1, const PointIdxRef& p2)
+                { return p1.compare(Dimension::Id::Z, p2); }));
+            for (PointId i = 0; i < v->size(); ++i)
+                zs.push_back(v->getFieldAs<double>(Dimension::Id::Z, i));
+        }
+        return zs;
+    };
+
+    std::vector<double> serial = run(1);
+    std::vector<double> parallel = run(4);
+    EXPECT_EQ(serial.size(), 1065u);
+    EXPECT_EQ(serial, parallel);
+}
+
+// Views run concurrently must not split their work among more threads.
+TEST(SplitterTest, parallelThreads)
+{
+    auto run = [](double length)
+    {
+        Options ro;
+        ro.add("bounds", BOX3D(0, 0, 0, 100, 100, 100));
+        ro.add("count", 1000);
+        ro.add("mode", "ramp");
+        FauxReader r;
+        r.setOptions(ro);
+
+        Options so;
+        so.add("length", length);
+        SplitterFilter s;
+        s.setOptions(so);
+        s.setInput(r);
+
+        Options fo;
+        fo.add("threads", 4);
+        ThreadsFilter filter;
+        filter.setOptions(fo);
+        filter.setInput(s);
+
+        PointTable table;
+        filter.prepare(table);
+        filter.execute(table);
+        return filter.m_threads;
+    };
+
+    // A single view may use all the threads.
+    std::vector<std::size_t> single = run(1000);
+    EXPECT_EQ(single, std::vector<std::size_t>(1, 4));
+
+    std::vector<std::size_t> split = run(25);
+    EXPECT_GT(split.size(), 1u);
+    for (std::size_t threads : split)
+        EXPECT_EQ(threads, 1u);
+}
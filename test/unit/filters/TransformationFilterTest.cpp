@@ -35,6 +35,7 @@
 #include <pdal/pdal_test_main.hpp>
 #include <FauxReader.hpp>
 #include <TransformationFilter.hpp>
+#include <StreamCallbackFilter.hpp>
 
 #include <pdal/StageFactory.hpp>
 
@@ -171,4 +172,45 @@ TEST_F(TransformationFilterTest, Rotation)
 }
 
 
+// Stream more points than fit in one table so that the filter sees
+// several batches.
+TEST(TransformationFilterStreamTest, Batch)
+{
+    Options readerOpts;
+    readerOpts.add("mode", "ramp");
+    readerOpts.add("count", 50);
+    readerOpts.add("bounds", BOX3D(0, 0, 0, 49, 98, 147));
+    FauxReader reader;
+    reader.setOptions(readerOpts);
+
+    Options filterOpts;
+    filterOpts.add("matrix", "0 1 0 1\n-1 0 0 2\n0 0 1 3\n0 0 0 1");
+    TransformationFilter filter;
+    filter.setOptions(filterOpts);
+    filter.setInput(reader);
+
+    StreamCallbackFilter f;
+    f.setInput(filter);
+
+    FixedPointTable table(16);
+    f.prepare(table);
+
+    int i = 0;
+    auto cb = [&i](PointRef& point)
+    {
+        EXPECT_DOUBLE_EQ(2 * i + 1,
+            point.getFieldAs<double>(Dimension::Id::X));
+        EXPECT_DOUBLE_EQ(-i + 2,
+            point.getFieldAs<double>(Dimension::Id::Y));
+        EXPECT_DOUBLE_EQ(3 * i + 3,
+            point.getFieldAs<double>(Dimension::Id::Z));
+        ++i;
+        return true;
+    };
+    f.setCallback(cb);
+    f.execute(table);
+    EXPECT_EQ(i, 50);
+}
+
+
 }
@@ -76,7 +76,7 @@ template<typename LeftIter, typename RightIter>
 
 
 
-void test_file_type_view(const std::string& filename)
+void test_file_type_view(const std::string& filename, bool mmap)
 {
     PointTable table;
 
@@ -91,6 +91,7 @@ void test_file_type_view(const std::string& filename)
 
     ops.add("filename", filename);
     ops.add("count", 506);
+    ops.add("use_mmap", mmap);
     std::shared_ptr<BpfReader> reader(new BpfReader);
     reader->setOptions(ops);
 
@@ -132,7 +133,7 @@ void test_file_type_view(const std::string& filename)
     }
 }
 
-void test_file_type_stream(const std::string& filename)
+void test_file_type_stream(const std::string& filename, bool mmap)
 {
     class Checker : public Filter
     {
@@ -196,6 +197,7 @@ void test_file_type_stream(const std::string& filename)
 
     ops.add("filename", filename);
     ops.add("count", 506);
+    ops.add("use_mmap", mmap);
     BpfReader reader;
     reader.setOptions(ops);
 
@@ -207,10 +209,10 @@ void test_file_type_stream(const std::string& filename)
 }
 
 
-void test_file_type(const std::string& filename)
+void test_file_type(const std::string& filename, bool mmap = false)
 {
-    test_file_type_view(filename);
-    test_file_type_stream(filename);
+    test_file_type_view(filename, mmap);
+    test_file_type_stream(filename, mmap);
 }
 
 
@@ -249,6 +251,13 @@ TEST(BPFTest, test_point_major)
         Support::datapath("bpf/autzen-utm-chipped-25-v3-interleaved.bpf"));
 }
 
+TEST(BPFTest, test_point_major_mmap)
+{
+    test_file_type(
+        Support::datapath("bpf/autzen-utm-chipped-25-v3-interleaved.bpf"),
+        true);
+}
+
 TEST(BPFTest, test_dim_major)
 {
     test_file_type(
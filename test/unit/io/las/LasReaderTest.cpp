@@ -401,7 +401,62 @@ TEST(LasReaderTest, lazperf)
 }
 #endif
 
-void streamTest(const std::string src, const std::string compression)
+#ifdef PDAL_HAVE_LASZIP
+// Chunks of the LAZ file are decompressed on several threads.  The points
+// must come out in file order and the callback must see each of them.
+TEST(LasReaderTest, laszipThreads)
+{
+    point_count_t count = 0;
+    Reader::PointReadFunc cb = [&count](PointView& view, PointId id)
+    {
+        EXPECT_EQ(id, count);
+        count++;
+    };
+
+    Options ops1;
+    ops1.add("filename", Support::datapath("laz/autzen_trim.laz"));
+    ops1.add("compression", "laszip");
+    ops1.add("threads", 4);
+
+    LasReader lazReader;
+    lazReader.setOptions(ops1);
+    lazReader.setReadCb(cb);
+
+    PointTable t1;
+    lazReader.prepare(t1);
+    PointViewSet pbSet = lazReader.execute(t1);
+    EXPECT_EQ(pbSet.size(), 1UL);
+    PointViewPtr view1 = *pbSet.begin();
+    EXPECT_EQ(view1->size(), (point_count_t)110000);
+    EXPECT_EQ(count, (point_count_t)110000);
+
+    Options ops2;
+    ops2.add("filename", Support::datapath("las/autzen_trim.las"));
+
+    LasReader lasReader;
+    lasReader.setOptions(ops2);
+
+    PointTable t2;
+    lasReader.prepare(t2);
+    pbSet = lasReader.execute(t2);
+    PointViewPtr view2 = *pbSet.begin();
+
+    DimTypeList dims = view1->dimTypes();
+    size_t pointSize = view1->pointSize();
+    EXPECT_EQ(view1->pointSize(), view2->pointSize());
+    std::vector<char> buf1(pointSize);
+    std::vector<char> buf2(pointSize);
+    for (PointId i = 0; i < 110000; i += 97)
+    {
+       view1->getPackedPoint(dims, i, buf1.data());
+       view2->getPackedPoint(dims, i, buf2.data());
+       EXPECT_EQ(memcmp(buf1.data(), buf2.data(), pointSize), 0);
+    }
+}
+#endif
+
+void streamTest(const std::string src, const std::string compression,
+    bool mmap = false)
 {
     Options ops1;
     ops1.add("filename", src);
@@ -451,6 +506,7 @@ void streamTest(const std::string src, const std::string compression)
 
     Options ops2;
     ops2.add("filename", Support::datapath("las/autzen_trim.las"));
+    ops2.add("use_mmap", mmap);
 
     LasReader lazReader;
     lazReader.setOptions(ops2);
@@ -494,6 +550,63 @@ TEST(LasReaderTest, LasHeaderIncorrentPointcount)
     EXPECT_EQ(1064u, view->size());
 }
 
+// Points decoded from a memory map must match those read from a stream,
+// and a file shorter than its header claims must stop at the last point.
+TEST(LasReaderTest, mmap)
+{
+    std::string filename(Support::datapath("las/autzen_trim.las"));
+
+    Options ops1;
+    ops1.add("filename", filename);
+
+    LasReader r1;
+    r1.setOptions(ops1);
+
+    PointTable t1;
+    r1.prepare(t1);
+    PointViewSet s1 = r1.execute(t1);
+    PointViewPtr v1 = *s1.begin();
+
+    Options ops2;
+    ops2.add("filename", filename);
+    ops2.add("use_mmap", true);
+
+    LasReader r2;
+    r2.setOptions(ops2);
+
+    PointTable t2;
+    r2.prepare(t2);
+    PointViewSet s2 = r2.execute(t2);
+    PointViewPtr v2 = *s2.begin();
+
+    EXPECT_EQ(v1->size(), v2->size());
+    DimTypeList dims = v1->dimTypes();
+    size_t pointSize = v1->pointSize();
+    std::vector<char> buf1(pointSize);
+    std::vector<char> buf2(pointSize);
+    for (PointId i = 0; i < v1->size(); i += 101)
+    {
+       v1->getPackedPoint(dims, i, buf1.data());
+       v2->getPackedPoint(dims, i, buf2.data());
+       EXPECT_EQ(memcmp(buf1.data(), buf2.data(), pointSize), 0);
+    }
+
+    // Stream the mapped file and compare with a standard read.
+    streamTest(filename, "laszip", true);
+
+    Options ops3;
+    ops3.add("filename", Support::datapath("las/1.2-with-color-clipped.las"));
+    ops3.add("use_mmap", true);
+
+    LasReader r3;
+    r3.setOptions(ops3);
+
+    PointTable t3;
+    r3.prepare(t3);
+    PointViewSet s3 = r3.execute(t3);
+    EXPECT_EQ(1064u, (*s3.begin())->size());
+}
+
 TEST(LasReaderTest, EmptyGeotiffVlr)
 {
     PointTable table;
@@ -586,6 +586,57 @@ TEST(LasWriterTest, lazperf)
 }
 #endif
 
+#ifdef PDAL_HAVE_LAZPERF
+// Chunks compressed in parallel must be written in order with the same
+// chunk table as sequential compression, in both standard and streaming
+// mode.
+TEST(LasWriterTest, lazperfThreads)
+{
+    auto write = [](const std::string& filename, int threads, bool stream)
+    {
+        FileUtils::deleteFile(filename);
+
+        Options readerOps;
+        readerOps.add("filename", Support::datapath("las/autzen_trim.las"));
+
+        LasReader reader;
+        reader.setOptions(readerOps);
+
+        Options writerOps;
+        writerOps.add("filename", filename);
+        writerOps.add("compression", "lazperf");
+        writerOps.add("threads", threads);
+
+        LasWriter writer;
+        writer.setOptions(writerOps);
+        writer.setInput(reader);
+
+        if (stream)
+        {
+            FixedPointTable t(1000);
+            writer.prepare(t);
+            writer.execute(t);
+        }
+        else
+        {
+            PointTable t;
+            writer.prepare(t);
+            writer.execute(t);
+        }
+    };
+
+    std::string serial(Support::temppath("serial.laz"));
+    std::string parallel(Support::temppath("parallel.laz"));
+    std::string streamed(Support::temppath("streamed.laz"));
+
+    write(serial, 1, false);
+    write(parallel, 4, false);
+    write(streamed, 3, true);
+    EXPECT_TRUE(Support::compare_files(serial, parallel));
+    EXPECT_TRUE(Support::compare_files(serial, streamed));
+}
+#endif
+
 void compareFiles(const std::string& name1, const std::string& name2,
     size_t increment = 100)
 {